@@ -15,11 +15,74 @@
  *  along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+/* To use, #include this wherever it's needed, and in exactly one source file #define CK_IMPLEMENTATION first, so the
+ * functions and globals get defined there (everywhere else just sees their declarations):
+ *
+ *     #define CK_IMPLEMENTATION
+ *     #include "conkit.h"
+ *
+ * That file should include it before any system header, so the POSIX functions it uses get declared even under -std=c11.
+ *
+ * Configuration macros (CK_ALLOC_SIZE, CK_POOL_THREADS, ...) must be the same in every file that includes it.
+ */
+
+#if defined(CK_IMPLEMENTATION) && !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* Declare POSIX (and common BSD) functions like pthread_sigmask() too when compiling strictly to a C standard */
+#endif
+
+#ifdef __cplusplus // C++ (for conkit.hpp) has the same atomics, just in std (these are all #undef'd again at the end, so they don't leak into whatever includes this)
+#include <atomic> // For sharing things between threads without locks
+
+#define atomic_size_t std::atomic_size_t
+#define atomic_load_explicit std::atomic_load_explicit
+#define atomic_store_explicit std::atomic_store_explicit
+#define atomic_store std::atomic_store
+#define atomic_fetch_add_explicit std::atomic_fetch_add_explicit
+#define atomic_exchange_explicit std::atomic_exchange_explicit
+#define memory_order_relaxed std::memory_order_relaxed
+#define memory_order_acquire std::memory_order_acquire
+#define memory_order_release std::memory_order_release
+
+#define _Bool bool
+#define _Alignas(n) alignas(n)
+#endif
+
+#ifndef CONKIT_H
+#define CONKIT_H
+
 #include <stdio.h> // For i/o
 #include <stdlib.h> // For calloc(), free(), and size_t
 #include <math.h> // For number of chars that size_t is to print
 #include <string.h> // For strcat(), memset(), strlen() (also size_t lol)
 
+#ifndef __cplusplus // (See above for C++)
+#include <stdatomic.h> // For sharing things between threads without locks
+#endif
+
+#ifdef _WIN32 // Windows
+
+#include <conio.h> // For getch(), kbhit()
+#include <windows.h> // For GetConsoleScreenBufferInfo(), other Windows nonsense
+
+#elif defined(unix) || \
+      defined(__unix) || \
+      defined(__unix__) || \
+      defined(__APPLE__) || \
+      defined(__MACH__)
+
+#include <unistd.h> // For sleep (and some other stuff I think, I can't remember)
+#include <pthread.h> // For threads
+
+#else // RIP (maybe support later)
+
+#error Could not be determined if system is Unix-like or Windows! I do not know how I should be implemented! Please `#define unix', or `#define _WIN32'.
+
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // Non-implementation-specific definitions:
 
 struct ck_console_size { // For console dimensions
@@ -28,199 +91,212 @@ struct ck_console_size { // For console dimensions
     _Bool has_changed; // Terminal was resized?
 };
 
-size_t CK_SCREEN_BUFFER_SIZE,
-       CK_SCREEN_BUFFER_END;
+extern size_t CK_SCREEN_BUFFER_SIZE,
+              CK_SCREEN_BUFFER_END;
+
+extern char *CK_SCREEN_BUFFER, // Buffer to write to that will be written to screen
+            *CK_SEQUENCE_BUFFER; // Buffer to store character sequences generated by ANSI abstraction-functions
 
-char *CK_SCREEN_BUFFER, // Buffer to write to that will be written to screen
-     *CK_SEQUENCE_BUFFER; // Buffer to store character sequences generated by ANSI abstraction-functions
+extern void *CK_ALLOC_BUFFER; // Buffer for memory-reallocation in case of failure
 
-void *CK_ALLOC_BUFFER; // Buffer for memory-reallocation in case of failure
+struct ck_segment { // A growable run of output, for building parts of a frame separately (e.g. on different threads) and writing them after CK_SCREEN_BUFFER
+    char *buffer;
+    size_t size,
+           end;
+};
 
 #ifndef CK_ALLOC_SIZE
 #define CK_ALLOC_SIZE 100
 #endif
 
-// Implementation-specific definitions:
+// Cell grid (an alternative to CK_SCREEN_BUFFER for apps that redraw parts of the screen):
 
-#ifdef _WIN32 // Windows
+#define CK_COLOUR_DEFAULT 0x1000000 /* The terminal's own default colour */
+#define CK_COLOUR_PALETTE 0x2000000 /* Flag for a 256-colour palette index rather than an RGB value */
 
-#include <conio.h> // For getch(), kbhit()
-#include <windows.h> // For GetConsoleScreenBufferInfo(), other Windows nonsense
+#define ck_colour_rgb(r, g, b) ((unsigned int)(r) << 16 | (unsigned int)(g) << 8 | (unsigned int)(b)) /* Pack an RGB value for a cell */
+#define ck_colour_256(index) (CK_COLOUR_PALETTE | (unsigned char)(index)) /* Pack a palette index for a cell */
 
-#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
-#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x4
-#endif
+#define CK_ATTR_BOLD 0x1
+#define CK_ATTR_DIM 0x2
+#define CK_ATTR_ITALIC 0x4
+#define CK_ATTR_UNDERLINE 0x8
+#define CK_ATTR_BLINK 0x10
+#define CK_ATTR_REVERSE 0x20
 
-#define sleep(ms) Sleep(ms)
+struct ck_cell { // One character-position on screen
+    unsigned int glyph, // Unicode code point
+                 fg, // Foreground colour (see ck_colour_rgb(), ck_colour_256(), CK_COLOUR_DEFAULT)
+                 bg; // Background colour
+    unsigned char attr; // CK_ATTR_* flags
+};
 
-HANDLE CK_STD_OUTPUT_HANDLE;
-DWORD CK_CONSOLE_MODE;
+struct ck_grid { // A width*height block of cells, stored row by row with each field in an array of its own (so runs of cells can be compared a vector at a time)
+    unsigned int *glyph,
+                 *fg,
+                 *bg;
+    unsigned char *attr;
+    unsigned long long *hashes; // Hash of each row, or 0 if it has been written to since it was last worked out (see ck_grid_hash_row())
+    size_t width,
+           height;
+};
 
-void ck_init(void) { // Initialise ck
-    // Enable ANSI escape sequences ("VIRTUAL_TERMINAL_PROCESSING"):
+struct ck_rect { // A rectangle of cells (co-ordinates are 0-based, unlike ck_cursor_goto())
+    size_t x, y,
+           width,
+           height;
+};
 
-    CK_STD_OUTPUT_HANDLE = GetStdHandle(STD_OUTPUT_HANDLE);
-    GetConsoleMode(CK_STD_OUTPUT_HANDLE, &CK_CONSOLE_MODE);
-    SetConsoleMode(CK_STD_OUTPUT_HANDLE, CK_CONSOLE_MODE | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
-    
-    // Allocate memory for CK_SCREEN_BUFFER:
-    
-    if((CK_SCREEN_BUFFER = calloc(CK_SCREEN_BUFFER_SIZE = CK_ALLOC_SIZE, sizeof(char))) == NULL) {
-        perror("Error allocating memory for CK_SCREEN_BUFFER: ");
-        exit(EXIT_FAILURE);
-    }
+#define CK_BLANK_CELL ((struct ck_cell){' ', CK_COLOUR_DEFAULT, CK_COLOUR_DEFAULT, 0})
+#define CK_UNKNOWN_CELL ((struct ck_cell){0, CK_COLOUR_DEFAULT, CK_COLOUR_DEFAULT, 0})
 
-    // Initialise CK_SCREEN_BUFFER:
-    
-    CK_SCREEN_BUFFER_END = 0;
-    memset(CK_SCREEN_BUFFER, '\0', CK_ALLOC_SIZE);
-    
-    // Allocate memory for CK_SEQUENCE_BUFFER:
-    
-    if((CK_SEQUENCE_BUFFER = calloc(2 * (log10(pow(2, sizeof(size_t) * 8) - 1) + 1) + 21, sizeof(char))) == NULL) { // Max length of a size_t in digits for base-10, times two because for one of the functions there is two size_t needed, plus 20 because the rgb function requires a 20 character string, plus 1 for \0
-        perror("Error allocating memory for CK_SEQUENCE_BUFFER: ");
-        exit(EXIT_FAILURE);
-    }
-}
+#define CK_WIDE_CONTINUATION 0x110000 /* Glyph of the cell covered by the right half of a double-width glyph (not a valid code point) */
 
-void ck_end(void) { // End usage of ck and put things back to normal
-    SetConsoleMode(CK_STD_OUTPUT_HANDLE, CK_CONSOLE_MODE); // Set console back to the way it was (don't leave them with escape codes enabled if that's how they were originally)
+#define ck_grid_index(grid, x, y) ((y) * (grid)->width + (x)) /* Index of the cell at (x, y) in each of the grid's arrays, no bounds-checking */
+#define ck_grid_touch(grid, y) ((grid)->hashes[y] = 0) /* Say row `y' has changed, after writing to the grid's arrays directly (the ck_grid_*() functions do this themselves) */
+#define ck_grid_free(grid) (free((grid)->glyph), free((grid)->fg), free((grid)->bg), free((grid)->attr), free((grid)->hashes), *(grid) = (struct ck_grid){NULL, NULL, NULL, NULL, NULL, 0, 0}) /* Free a grid's arrays, leaving it empty */
 
-    // Free allocated memory:
-    
-    free(CK_SCREEN_BUFFER);
-    free(CK_SEQUENCE_BUFFER);
-}
+extern struct ck_grid CK_GRID, // The grid that gets drawn to, and whose damaged regions are written on ck_flip()
+                      CK_GRID_DISPLAYED; // What is believed to be on screen, for ck_present() to diff against (a glyph of 0 means unknown)
 
-struct ck_console_size ck_current_console_size(void) { // Get current terminal dimensions
-    size_t newWidth, newHeight;
+extern size_t CK_DAMAGE_BUFFER_SIZE,
+              CK_DAMAGE_BUFFER_END;
 
-    static struct ck_console_size knownSize = {0, 0, 0};
-    CONSOLE_SCREEN_BUFFER_INFO currentBufferInfo;
+extern struct ck_rect *CK_DAMAGE_BUFFER; // Regions of CK_GRID that have changed since the last ck_flip()
 
-    // Get the info:
-    
-    GetConsoleScreenBufferInfo(CK_STD_OUTPUT_HANDLE, &currentBufferInfo);
+extern size_t CK_BAND_BUFFER_SIZE,
+              CK_BAND_BUFFER_END;
 
-    // Work out dimensions:
-    
-    newWidth = currentBufferInfo.srWindow.Right - currentBufferInfo.srWindow.Left + 1,
-    newHeight = currentBufferInfo.srWindow.Bottom - currentBufferInfo.srWindow.Top + 1;
+extern struct ck_segment *CK_BAND_BUFFER; // Output of ck_present() for each band of rows, written in order by ck_flip() (kept between frames so their memory gets reused)
 
-    // Modify return value if they differ from what's already known:
-    
-    if((knownSize.has_changed = newWidth != knownSize.width || newHeight != knownSize.height))
-        knownSize.width = newWidth,
-        knownSize.height = newHeight;
+#define CK_CAP_REP 0x1 /* Terminal can repeat the last character (`CSI n b') */
 
-    return knownSize;
-}
+extern unsigned int CK_CAPABILITIES; // CK_CAP_* flags for optional sequences the terminal supports (see ck_probe_capabilities(), or set them yourself)
 
-// Unix-like:
+#ifndef CK_PROBE_TIMEOUT
+#define CK_PROBE_TIMEOUT 100 /* Milliseconds to wait for the terminal to answer a probe */
+#endif
 
-#elif defined(unix) || \
-      defined(__unix) || \
-      defined(__unix__) || \
-      defined(__APPLE__) || \
-      defined(__MACH__)
+// Input events (decoded from what the terminal sends):
 
-#include <termios.h> // For disabling input echo and buffering
-#include <unistd.h> // For sleep (and some other stuff I think, I can't remember)
-#include <poll.h> // To poll stdin for my implementation of kbhit()
-#include <sys/ioctl.h> // To get terminal dimensions
+#define CK_EVENT_KEY 1
+#define CK_EVENT_RESIZE 2
+#define CK_EVENT_MOUSE_DOWN 3 /* Button pressed, or wheel turned */
+#define CK_EVENT_MOUSE_UP 4
+#define CK_EVENT_MOUSE_MOVE 5 /* Moved, dragging if a button is held (only the latest position is delivered each time input is read) */
+#define CK_EVENT_PASTE 6 /* Text pasted while bracketed paste is enabled, delivered all at once */
 
-#define sleep(ms) usleep(ms * 1000)
+#define CK_KEY_UP 0x110001 /* Key codes for keys that aren't characters (beyond the last code point) */
+#define CK_KEY_DOWN 0x110002
+#define CK_KEY_RIGHT 0x110003
+#define CK_KEY_LEFT 0x110004
+#define CK_KEY_HOME 0x110005
+#define CK_KEY_END 0x110006
+#define CK_KEY_INSERT 0x110007
+#define CK_KEY_DELETE 0x110008
+#define CK_KEY_PAGE_UP 0x110009
+#define CK_KEY_PAGE_DOWN 0x11000A
+#define CK_KEY_F(n) (0x110010 + (n)) /* Function keys F1 to F12 */
 
-struct termios CK_CONSOLE_SETTS,
-               CK_CONSOLE_ORIG_SETTS;
+#define CK_MOD_SHIFT 0x1
+#define CK_MOD_ALT 0x2
+#define CK_MOD_CTRL 0x4
 
-char getch(void) { // My implementation of the getch() function
-    char ret;
+#define CK_MOUSE_NONE 0 /* Mouse buttons (moving without one held) */
+#define CK_MOUSE_LEFT 1
+#define CK_MOUSE_MIDDLE 2
+#define CK_MOUSE_RIGHT 3
+#define CK_MOUSE_WHEEL_UP 4
+#define CK_MOUSE_WHEEL_DOWN 5
 
-    // Change settings, get char, revert settings, return value:
-    
-    tcsetattr(0, TCSANOW, &CK_CONSOLE_SETTS);
+struct ck_event { // Something that happened, for an event callback
+    int type; // CK_EVENT_*
+    unsigned int key, // CK_EVENT_KEY: code point, or CK_KEY_*; CK_EVENT_MOUSE_*: CK_MOUSE_* button
+                 modifiers; // CK_EVENT_KEY and CK_EVENT_MOUSE_*: CK_MOD_* flags
+    size_t width, // CK_EVENT_RESIZE: new terminal dimensions
+           height,
+           x, y, // CK_EVENT_MOUSE_*: cell position (0-based)
+           len; // CK_EVENT_PASTE: length of `text'
+    const char *text; // CK_EVENT_PASTE: what was pasted (not \0-terminated, and only valid until the callback returns)
+    unsigned long long time; // When it was read, in ns (see ck_now())
+};
 
-    ret = getchar();
+typedef void (*ck_event_callback)(const struct ck_event *event, void *data);
 
-    tcsetattr(0, TCSANOW, &CK_CONSOLE_ORIG_SETTS);
+extern size_t CK_INPUT_BUFFER_SIZE,
+              CK_INPUT_BUFFER_END;
 
-    return ret;
-}
+extern char *CK_INPUT_BUFFER; // Input that has been read but not yet decoded (a partial escape sequence, say)
 
-_Bool kbhit(void) { // My own implementation of the kbhit() function
-    static struct pollfd fd_buff[] = {{.fd = STDIN_FILENO, // File descriptor for stdin
-                                       .events = POLLIN}};
+extern size_t CK_PASTE_SEARCHED; // How much of an unfinished paste has been checked for its end already, so a big one isn't rescanned on every read
 
-    tcsetattr(0, TCSANOW, &CK_CONSOLE_SETTS); // Set non-echo, non-buffering settings
+extern unsigned long long CK_INPUT_READ_TIME; // When what's in CK_INPUT_BUFFER was read, for stamping events with
 
-    poll(fd_buff, 1, 0); // Poll the items in the file descriptor array, waiting 0s for each (since kbhit() will be called to check if the keyboard has *been* hit, not to wait for it to *be* hit)
+// Input latency (from an event being read to the ck_flip() that follows it being handled):
 
-    tcsetattr(0, TCSANOW, &CK_CONSOLE_ORIG_SETTS); // Revert settings
+#ifndef CK_LATENCY_SAMPLES
+#define CK_LATENCY_SAMPLES 1024 /* How many of the latest latencies are kept for ck_latency_stats() */
+#endif
 
-    return fd_buff[0].revents & POLLIN; // So, was there input?
-}
+struct ck_latency_stats { // Percentiles of the kept latencies, in ns
+    size_t samples;
+    unsigned long long p50,
+                       p90,
+                       p99,
+                       max;
+};
 
-void ck_init(void) { // Initialise ck
-    // Pre-compute unechoed-and-unbuffered-input attributes (and original attributes) so they can be readily applied:
+extern unsigned long long CK_LATENCY_BUFFER[CK_LATENCY_SAMPLES], // Ring of the latest latencies
+                          CK_LATENCY_PENDING; // Read time of the earliest event handled since the last ck_flip() (0 if none)
 
-    tcgetattr(0, &CK_CONSOLE_ORIG_SETTS);
-    CK_CONSOLE_SETTS = CK_CONSOLE_ORIG_SETTS;
+extern size_t CK_LATENCY_COUNT; // How many latencies have been measured in all
 
-    CK_CONSOLE_SETTS.c_lflag &= ~ECHO & ~ICANON;
+// Implementation-specific definitions:
 
-    // Allocate memory for CK_SCREEN_BUFFER:
+#ifdef _WIN32 // Windows
 
-    if((CK_SCREEN_BUFFER = calloc(CK_SCREEN_BUFFER_SIZE = CK_ALLOC_SIZE, sizeof(char))) == NULL) {
-        perror("Error allocating memory for CK_SCREEN_BUFFER: ");
-        exit(EXIT_FAILURE);
-    }
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x4
+#endif
 
-    // Initialise CK_SCREEN_BUFFER:
-    
-    CK_SCREEN_BUFFER_END = 0;
-    memset(CK_SCREEN_BUFFER, '\0', CK_ALLOC_SIZE);
-    
-    // Allocate memory for CK_SEQUENCE_BUFFER:
-    
-    if((CK_SEQUENCE_BUFFER = calloc(2 * (log10(pow(2, sizeof(size_t) * 8) - 1) + 1) + 21, sizeof(char))) == NULL) { // Max length of a size_t in digits for base-10, times two because for one of the functions there is two size_t needed, plus 20 because the rgb function requires a 20 character string, plus 1 for \0
-        perror("Error allocating memory for CK_SEQUENCE_BUFFER: ");
-        exit(EXIT_FAILURE);
-    }
-}
+#define sleep(ms) Sleep(ms)
 
-void ck_end(void) { // End usage of ck and put things back to normal
-    // Free allocated memory:
+typedef HANDLE ck_thread;
 
-    free(CK_SCREEN_BUFFER);
-    free(CK_SEQUENCE_BUFFER);
-}
+typedef SRWLOCK ck_mutex;
+typedef CONDITION_VARIABLE ck_cond;
 
-struct ck_console_size ck_current_console_size(void) { // Get current terminal dimensions
-    struct winsize newDims;
+#define ck_mutex_init(mutex) InitializeSRWLock(mutex)
+#define ck_mutex_lock(mutex) AcquireSRWLockExclusive(mutex)
+#define ck_mutex_unlock(mutex) ReleaseSRWLockExclusive(mutex)
 
-    static struct ck_console_size knownSize = {0, 0, 0};
-    
-    // Get the dimensions:
-    
-    ioctl(0, TIOCGWINSZ, &newDims);
-    
-    // Modify return value if they differ from what's already known:
-    
-    if((knownSize.has_changed = newDims.ws_col != knownSize.width || newDims.ws_row != knownSize.height))
-        knownSize.width = newDims.ws_col,
-        knownSize.height = newDims.ws_row;
+#define ck_cond_init(cond) InitializeConditionVariable(cond)
+#define ck_cond_wait(cond, mutex) SleepConditionVariableSRW((cond), (mutex), INFINITE, 0) /* Unlock `mutex' while waiting to be woken */
+#define ck_cond_broadcast(cond) WakeAllConditionVariable(cond) /* Wake everything waiting */
 
-    return knownSize;
-}
+#else // Unix-like
 
-#else // RIP (maybe support later)
+#define sleep(ms) usleep(ms * 1000)
 
-#error Could not be determined if system is Unix-like or Windows! I do not know how I should be implemented! Please `#define unix', or `#define _WIN32'.
+typedef pthread_t ck_thread;
+
+typedef pthread_mutex_t ck_mutex;
+typedef pthread_cond_t ck_cond;
+
+#define ck_mutex_init(mutex) pthread_mutex_init((mutex), NULL)
+#define ck_mutex_lock(mutex) pthread_mutex_lock(mutex)
+#define ck_mutex_unlock(mutex) pthread_mutex_unlock(mutex)
+
+#define ck_cond_init(cond) pthread_cond_init((cond), NULL)
+#define ck_cond_wait(cond, mutex) pthread_cond_wait((cond), (mutex)) /* Unlock `mutex' while waiting to be woken */
+#define ck_cond_broadcast(cond) pthread_cond_broadcast(cond) /* Wake everything waiting */
+
+char getch(void); // My implementation of the getch() function
+_Bool kbhit(void); // My own implementation of the kbhit() function
 
 #endif
 
-// Non-implementation-specific function definitions:
+// Escape sequences:
 
 // Versions for non-literal arguments:
 
@@ -244,40 +320,30 @@ struct ck_console_size ck_current_console_size(void) { // Get current terminal d
 #define CK_RESET_FORMATTING "\033[0m"
 #define CK_SHOW_CURSOR "\033[?25h"
 #define CK_HIDE_CURSOR "\033[?25l"
+#define CK_RESET_SCROLL_REGION "\033[r"
 
-char *ck_rgb(unsigned char where, // Generate ANSI escape-sequence string for specified RGB value
-             unsigned char r,
-             unsigned char g,
-             unsigned char b) {
+#define CK_ENABLE_MOUSE_CLICKS "\033[?1000h\033[?1006h" /* Report presses, releases, and the wheel (in SGR format, so positions aren't limited to 223) */
+#define CK_ENABLE_MOUSE_DRAG "\033[?1002h\033[?1006h" /* ...and movement while a button is held */
+#define CK_ENABLE_MOUSE_MOTION "\033[?1003h\033[?1006h" /* ...and all movement */
+#define CK_DISABLE_MOUSE "\033[?1003l\033[?1002l\033[?1000l\033[?1006l"
 
-    sprintf(CK_SEQUENCE_BUFFER,
-            "\033[%d;2;%d;%d;%dm",
-            where,
-            r, g, b);
-    
-    return CK_SEQUENCE_BUFFER;
-}
+#define CK_ENABLE_PASTE "\033[?2004h" /* Have pastes marked, so they come as one CK_EVENT_PASTE rather than as keys */
+#define CK_DISABLE_PASTE "\033[?2004l"
 
 #define ck_bg_rgb(r, g, b) ck_rgb(48, (r), (g), (b)) /* Background */
 #define ck_fg_rgb(r, g, b) ck_rgb(38, (r), (g), (b)) /* Foreground */
 
-char *ck_cursor_goto(size_t x, size_t y) { // Generate ANSI escape-sequence string for cursor movement to specified co-ordinates
-    sprintf(CK_SEQUENCE_BUFFER, "\033[%zu;%zuH", y, x);
-
-    return CK_SEQUENCE_BUFFER;
-}
-
-char *ck_cursor_move(char where, size_t amount) { // Generate ANSI escape-sequence string for cursor movement in a direction relative-to current position
-    sprintf(CK_SEQUENCE_BUFFER, "\033[%zu%c", amount, where);
-
-    return CK_SEQUENCE_BUFFER;
-}
-
 #define ck_cursor_up(amount) ck_cursor_move('A', (amount)) /* move cursor upward by `amount' lines */
 #define ck_cursor_down(amount) ck_cursor_move('B', (amount)) /* Move cursor downward by `amount' lines */
 #define ck_cursor_right(amount) ck_cursor_move('C', (amount)) /* Move cursor rightward by `amount' chars */
 #define ck_cursor_left(amount) ck_cursor_move('D', (amount)) /* Move cursor leftward by `amount' chars */
 
+#define ck_scroll_up(amount) ck_cursor_move('S', (amount)) /* Scroll the scrolling region's content upward by `amount' lines (not really a cursor movement, but the same shape of sequence) */
+#define ck_scroll_down(amount) ck_cursor_move('T', (amount)) /* Scroll the scrolling region's content downward by `amount' lines */
+
+#define ck_insert_lines(amount) ck_cursor_move('L', (amount)) /* Insert `amount' blank lines at the cursor's line, pushing it and those below downward */
+#define ck_delete_lines(amount) ck_cursor_move('M', (amount)) /* Delete `amount' lines from the cursor's line, pulling those below upward */
+
 // Versions that should be used when the specified arguments are literals:
 
 #define ck_bg_rgb_l(r, g, b) "\033[48;2;" #r ";" #g ";" #b "m" /* Background RGB value */
@@ -290,35 +356,4516 @@ char *ck_cursor_move(char where, size_t amount) { // Generate ANSI escape-sequen
 #define ck_cursor_right_l(amount) "\033[" #amount "C" /* Move cursor rightward by `amount' chars */
 #define ck_cursor_left_l(amount) "\033[" #amount "D" /* Move cursor leftward by `amount' chars */
 
-// Other functions:
+#define ck_scroll_up_l(amount) "\033[" #amount "S" /* Scroll upward by `amount' lines */
+#define ck_scroll_down_l(amount) "\033[" #amount "T" /* Scroll downward by `amount' lines */
 
-void ck_print(char *buffer) { // Write a string to the CK_SCREEN_BUFFER
-    size_t len = strlen(buffer) + 1;
+#define ck_insert_lines_l(amount) "\033[" #amount "L" /* Insert `amount' blank lines at the cursor */
+#define ck_delete_lines_l(amount) "\033[" #amount "M" /* Delete `amount' lines at the cursor */
 
-    // Automatic reallocation if needed:
+#define ck_scroll_region_l(top, bottom) "\033[" #top ";" #bottom "r" /* Restrict scrolling to lines `top' to `bottom' */
 
-    while(CK_SCREEN_BUFFER_END + len + 1 > CK_SCREEN_BUFFER_SIZE) // Calculate new size
-        CK_SCREEN_BUFFER_SIZE += CK_ALLOC_SIZE;
-    
-    CK_SCREEN_BUFFER_END += len + 1;
-    
-    if((CK_ALLOC_BUFFER = (void *)realloc(CK_SCREEN_BUFFER, CK_SCREEN_BUFFER_SIZE * sizeof(char))) == NULL) { // Reallocate
-        perror("Error reallocating memory for CK_SCREEN_BUFFER: ");
+// Cell grid:
 
-        free(CK_SCREEN_BUFFER);
-        free(CK_SEQUENCE_BUFFER);
+struct ck_sgr_state { // Colours and attributes the terminal was last told to use
+    unsigned int fg,
+                 bg;
+    unsigned char attr;
+    _Bool known; // If not, the next cell written will reset them all first
+};
 
-        exit(EXIT_FAILURE);
-    }
+// Text scanning:
 
-    CK_SCREEN_BUFFER = (char *)CK_ALLOC_BUFFER;
-    
-    strcat(CK_SCREEN_BUFFER, buffer);
-}
+struct ck_text_scan { // What ck_scan_text() found
+    size_t ascii, // Length of the run of ASCII at the start
+           controls, // Number of control chars (including escapes and DEL)
+           escapes; // Number of escape chars (so the text probably contains sequences)
+    _Bool valid; // Whether it's all well-formed UTF-8
+};
 
-void ck_flip(void) { // Print the contents of CK_SCREEN_BUFFER and subsequently clear it
-    printf("\033[H%s", CK_SCREEN_BUFFER);
+// Thread pool:
 
-    memset(CK_SCREEN_BUFFER, '\0', CK_SCREEN_BUFFER_SIZE);
-    CK_SCREEN_BUFFER_END = 0;
-}
+typedef void (*ck_job)(size_t index, void *data);
+
+// Tiles:
+
+typedef void (*ck_tile_callback)(struct ck_grid *tile, void *data);
+
+struct ck_tile { // A rectangle of CK_GRID with its own cells, so it can be drawn without touching anyone else's
+    struct ck_rect rect; // Where it goes on CK_GRID
+    struct ck_grid grid; // What gets drawn into (starts blank)
+    ck_tile_callback draw; // Called with `grid' to draw the tile
+    void *data;
+};
+
+// Sprites:
+
+struct ck_sprite { // A block of cells to be blitted onto a grid, some of which can be transparent
+    struct ck_grid cells; // What it looks like (can be drawn into with the ck_grid_*() functions, but see ck_sprite_put())
+    unsigned char *mask; // 1 for each cell that gets drawn, 0 for each that lets what's underneath show through
+};
+
+// Pixel canvases:
+
+#define CK_CANVAS_RGB 0 /* Colours as they are (needs a terminal with 24-bit colour) */
+#define CK_CANVAS_256 1 /* Nearest colour in the 256-colour palette's 6x6x6 cube */
+#define CK_CANVAS_256_ORDERED 2 /* ...dithered with a 4x4 Bayer matrix (stable from frame to frame, so cheap to diff) */
+#define CK_CANVAS_256_DIFFUSED 3 /* ...dithered with Floyd-Steinberg error diffusion (smoother, but noisier to diff when things move) */
+
+struct ck_canvas { // Pixels drawn two to a cell with half blocks, so a canvas `height' pixels tall takes up `height / 2' rows
+    unsigned int *pixels; // Colour of each pixel, as ck_colour_rgb() packs it, row by row
+    int *errors; // Quantisation error carried to the next two rows, for CK_CANVAS_256_DIFFUSED (scratch space for ck_canvas_draw(), which is why that takes the canvas as non-const)
+    size_t width,
+           height; // Always even
+};
+
+#define ck_canvas_pixel(canvas, x, y) ((canvas)->pixels[(y) * (canvas)->width + (x)]) /* The pixel at (x, y), to read or assign, no bounds-checking */
+
+// Braille canvases:
+
+struct ck_braille { // A bitmap shown with braille patterns, 2x4 dots to a cell
+    unsigned char *cells; // A byte of dots for each cell, row by row, with the bits in Unicode's order (so a cell's glyph is just U+2800 plus its byte)
+    size_t width, // In dots (always a multiple of 2)
+           height; // In dots (always a multiple of 4)
+};
+
+static const unsigned char CK_BRAILLE_BITS[4][2] = { // Bit for each dot of a cell, by [y][x]
+    {0x01, 0x08},
+    {0x02, 0x10},
+    {0x04, 0x20},
+    {0x40, 0x80}
+};
+
+#define ck_braille_cell(braille, x, y) ((braille)->cells[((y) >> 2) * ((braille)->width >> 1) + ((x) >> 1)]) /* Byte of the cell that dot (x, y) is in */
+#define ck_braille_set(braille, x, y) (ck_braille_cell(braille, x, y) |= CK_BRAILLE_BITS[(y) & 3][(x) & 1]) /* Set dot (x, y), no bounds-checking */
+#define ck_braille_unset(braille, x, y) (ck_braille_cell(braille, x, y) &= ~CK_BRAILLE_BITS[(y) & 3][(x) & 1]) /* Clear dot (x, y), no bounds-checking */
+#define ck_braille_get(braille, x, y) (ck_braille_cell(braille, x, y) & CK_BRAILLE_BITS[(y) & 3][(x) & 1]) /* Whether dot (x, y) is set, no bounds-checking */
+
+// File views:
+
+#ifndef CK_VIEW_CHECKPOINT
+#define CK_VIEW_CHECKPOINT 1024 /* A view's index keeps where every this-many'th line starts (the rest are counted from the nearest one when needed) */
+#endif
+
+#define CK_VIEW_CHUNK 4096 /* Checkpoints per block of a view's index (blocks are allocated as the index grows, and never move) */
+
+#ifndef CK_VIEW_COMPARE
+#define CK_VIEW_COMPARE 4096 /* Chars at the start and end of what a view had that ck_view_reload() checks are still there, to tell a file that's grown from one that's been replaced */
+#endif
+
+struct ck_view { // A window onto a text file that's mapped into memory rather than read in, so only the lines being shown ever get looked at
+    char *path; // The file's path (for picking up changes to it)
+    const char *data; // The file's contents
+    size_t size, // Its length
+           top; // Where the line at the top of the window starts
+    struct ck_rect window; // Where it was last drawn on screen
+    size_t **index; // Blocks of where lines 0, CK_VIEW_CHECKPOINT, 2 * CK_VIEW_CHECKPOINT... start, filled in by a thread in the background
+    size_t blocks; // How many blocks `index' has room for
+    atomic_size_t checkpoints, // How many have been filled in so far
+                  counted, // How many newlines have been found so far
+                  scanned, // How far into the file they've been looked for
+                  stop; // Set to have the indexing thread give up
+    ck_thread indexer;
+#ifdef __linux__
+    int watch, // inotify instance while it's being followed (see ck_view_follow()), -1 otherwise
+        timer; // Timer for the next refresh
+    unsigned int interval; // Ms between refreshes
+    _Bool pending; // Whether a refresh is due (the timer is only running while one is)
+#endif
+    struct ck_search *search; // Matches to highlight (see ck_search_start()), NULL for none
+};
+
+// Searching:
+
+#define CK_SEARCH_CHUNK 1024 /* Matches in the first block of a search's results (each one after holds twice as many as the last, so they never need to move) */
+#define CK_SEARCH_BLOCKS 48
+
+struct ck_search { // Where a string appears in a view's file, found by a thread in the background (so matches can be shown while it's still going)
+    struct ck_view *view;
+    char *needle; // What's being searched for
+    size_t len; // Its length
+    size_t *blocks[CK_SEARCH_BLOCKS]; // Where each match starts, in order (they don't overlap)
+    atomic_size_t found, // How many matches there are so far
+                  searched, // How far into the file it's got
+                  stop; // Set to have the thread give up
+    ck_thread thread;
+    struct ck_cell highlight; // Formatting for matches when the view is drawn (its glyph isn't used)
+};
+
+// Tables:
+
+#define CK_TABLE_HEADER ((size_t)-1) /* Row a table asks for to get its columns' titles */
+
+#ifndef CK_TABLE_WIDEST
+#define CK_TABLE_WIDEST 255 /* Widest a table's columns get (anything wider is cut off) */
+#endif
+
+#ifndef CK_TABLE_GAP
+#define CK_TABLE_GAP 2 /* Columns of space between a table's columns */
+#endif
+
+typedef const char *(*ck_table_callback)(size_t row, size_t column, size_t *len, void *data); // Gets the text of a cell, setting `len' to its length (it only has to stay valid until the next call)
+typedef int (*ck_table_compare)(size_t a, size_t b, void *data); // Whether row `a' goes before (< 0) or after (> 0) row `b' when sorted
+
+struct ck_table { // Rows of text in columns, only looked at when they change or are on screen (so there can be millions)
+    ck_table_callback cell;
+    void *data; // Passed to `cell'
+    size_t rows,
+           columns;
+    unsigned char *widths; // How wide each cell is, header first, then row by row
+    size_t *counts, // How many cells of each width (0 to CK_TABLE_WIDEST) each column has, so a column's widest is known without looking at every row again when one changes
+           *widest; // How wide each column is
+    size_t *order; // Which row is at each position (see ck_table_sort())
+    size_t top; // Position of the row at the top of the window
+    struct ck_cell header; // Formatting for the titles (bold by default; its glyph isn't used)
+};
+
+// Progress bars:
+
+#define CK_PROGRESS_UNITS 1024 /* What a bar's share of its ck_progress's running sum is out of */
+
+struct ck_progress;
+
+struct ck_progress_bar { // One task's progress, which any thread can update without locking (see ck_progress_add())
+    const char *label;
+    atomic_size_t done, // How much of it is done
+                  total, // Out of how much
+                  counted; // What it's added to its ck_progress's running totals (CK_PROGRESS_UNITS done, times 2, plus 1 if it's finished)
+    struct ck_progress *progress; // The one it belongs to
+    size_t drawn; // Eighths of a cell filled in when it was last drawn ((size_t)-1 if it hasn't been)
+    unsigned int percent; // Percentage shown when it was last drawn
+};
+
+struct ck_progress { // Lots of progress bars, of which only those that fit on screen are shown (the rest are summed up on a line at the bottom)
+    struct ck_progress_bar *bars;
+    size_t count, // How many there are
+           top; // Which is at the top of the window
+    struct ck_rect window; // Where they were last drawn on screen
+    size_t labelWidth, // Columns the labels get
+           barWidth; // and the bars
+    atomic_size_t finished, // How many bars are finished
+                  sum; // and the CK_PROGRESS_UNITS of all of them that are done (both kept up to date by the bars themselves, so the summary line needn't look at every bar)
+    size_t summed[2]; // `finished' and `sum' when the summary line was last written
+    char summary[96]; // What the line summing up the rest said when it was last drawn
+#ifdef __linux__
+    int timer; // Timer for redrawing while ck_run() is running (see ck_progress_start()), -1 if there isn't one
+#endif
+};
+
+#ifdef __linux__ // Event loop
+
+typedef void (*ck_fd_callback)(int fd, void *data);
+typedef void (*ck_timer_callback)(void *data);
+
+extern int CK_LOOP_FD, // The epoll instance (0 until first needed, since that's stdin so can't be it)
+           CK_RESIZE_FD; // signalfd for SIGWINCH while ck_run() is running
+
+// For another event loop to wait on (the epoll fd is readable whenever any of the others are, so is the only one that needs watching):
+
+#define ck_loop_fd() (CK_LOOP_FD) /* Readable when there's something for ck_process_ready() to do (valid after ck_loop_start()) */
+#define ck_input_fd() (STDIN_FILENO) /* Readable when there's input */
+#define ck_resize_fd() (CK_RESIZE_FD) /* Readable when the terminal has been resized (valid after ck_loop_start()) */
+
+#define ck_process_ready() ck_wait_and_dispatch(0) /* Dispatch whatever is ready without ever blocking, returning how many things were (for calling from another event loop when ck_loop_fd() is readable) */
+
+#endif
+
+// Functions (defined where CK_IMPLEMENTATION is):
+
+void ck_init(void); // Initialise ck
+void ck_end(void); // End usage of ck and put things back to normal
+unsigned int ck_probe_capabilities(void); // Find out which optional sequences the terminal supports, setting (and returning) CK_CAPABILITIES (only the cells it writes to test with get blanked, wherever the cursor is, and the cursor's put back)
+struct ck_console_size ck_current_console_size(void); // Get current terminal dimensions
+void ck_output_frame(const struct ck_segment *segments, size_t count); // Write the cursor home, CK_SCREEN_BUFFER, and then `count' segments to the terminal
+unsigned long long ck_now(void); // Current time from a monotonic clock, in ns
+
+ck_thread ck_thread_start(void *(*function)(void *), void *arg); // Start a thread running `function(arg)'
+void ck_thread_join(ck_thread thread); // Wait for a thread to finish
+size_t ck_cpu_count(void); // How many processors there are to run threads on
+
+char *ck_rgb(unsigned char where, // Generate ANSI escape-sequence string for specified RGB value
+             unsigned char r,
+             unsigned char g,
+             unsigned char b);
+char *ck_cursor_goto(size_t x, size_t y); // Generate ANSI escape-sequence string for cursor movement to specified co-ordinates
+char *ck_cursor_move(char where, size_t amount); // Generate ANSI escape-sequence string for cursor movement in a direction relative-to current position
+char *ck_scroll_region(size_t top, size_t bottom); // Generate ANSI escape-sequence string for restricting scrolling to lines `top' to `bottom' (inclusive)
+
+void ck_grow_screen_buffer(size_t len); // Make room for `len' more chars (and a \0) at the end of the CK_SCREEN_BUFFER
+void ck_segment_write(struct ck_segment *segment, const char *buffer, size_t len); // Write `len' bytes of `buffer' to the end of `segment' (or to the CK_SCREEN_BUFFER if it's NULL)
+
+int ck_glyph_width(unsigned int glyph); // How many columns a code point takes up on screen (0, 1, or 2)
+unsigned int ck_utf8_decode(const char *text, size_t len, size_t *used); // Decode the code point at the start of `text' (at most `len' chars), setting `used' to how many chars it took up (malformed sequences decode to U+FFFD, one char at a time)
+size_t ck_ascii_span(const char *text, size_t len); // How many chars at the start of `text' are printable ASCII (and so 1 column each)
+struct ck_text_scan ck_scan_text(const char *text, size_t len); // Validate UTF-8 and count control chars, checking runs of ASCII a vector at a time
+size_t ck_utf8_width(const char *text, size_t len); // How many columns `len' chars of UTF-8 take up on screen
+
+size_t ck_grid_match(const struct ck_grid *a, size_t aIndex, const struct ck_grid *b, size_t bIndex, size_t count); // How many of the `count' cells from `aIndex' of `a' match those from `bIndex' of `b' before the first that doesn't (comparing a vector's worth at a time)
+unsigned long long ck_grid_hash_row(struct ck_grid *grid, size_t y); // Hash of row `y' (never 0), only worked out again if the row has been written to since last time
+size_t ck_sgr(char *out, struct ck_sgr_state *state, const struct ck_cell *cell); // Write the shortest SGR sequence (at most 50 chars) that takes the terminal from `state' to `cell''s formatting, and update `state'
+void ck_write_cells(const struct ck_grid *grid, size_t index, size_t count, _Bool toEdge, struct ck_sgr_state *state, struct ck_segment *segment); // Write `count' cells from `index' of the grid to `segment' (or the CK_SCREEN_BUFFER if it's NULL) at the current cursor position, only changing formatting where needed (`toEdge' says the run ends at the right of the screen; the cursor is left somewhere on the row)
+void ck_grid_resize(struct ck_grid *grid, size_t width, size_t height); // (Re)allocate a grid, keeping whatever content still fits and blanking the rest
+void ck_grid_put(struct ck_grid *grid, size_t x, size_t y, struct ck_cell cell); // Set a single cell, and the one to its right if the glyph is double-width (ignored if off the grid)
+void ck_grid_fill(struct ck_grid *grid, size_t x, size_t y, size_t width, size_t height, struct ck_cell cell); // Set every cell in a rectangle (clipped to the grid) to a single-width glyph
+size_t ck_grid_text(struct ck_grid *grid, size_t x, size_t y, const char *text, unsigned int fg, unsigned int bg, unsigned char attr); // Write a UTF-8 string into a row of the grid, returning how many columns were written (stops at the edge; cells hold one code point, so combining marks are dropped)
+void ck_grid_scroll(struct ck_grid *grid, size_t y, size_t height, long amount); // Move rows `y' to `y + height - 1' of the grid upward by `amount' rows (downward if negative), blanking the ones left behind
+void ck_damage(size_t x, size_t y, size_t width, size_t height); // Mark a rectangle of CK_GRID as needing to be written on the next ck_flip()
+void ck_latency_mark(const struct ck_event *event); // Count the next ck_flip() as showing the result of handling `event' (done for you by ck_run() and ck_poll_event())
+struct ck_latency_stats ck_latency_stats(void); // Percentiles of the latest CK_LATENCY_SAMPLES input latencies
+void ck_flip(void); // Print the contents of CK_SCREEN_BUFFER followed by the damaged regions of CK_GRID (and anything ck_present() put in CK_BAND_BUFFER), and subsequently clear them
+void ck_write_scroll(size_t y, size_t height, long amount); // Write the sequences for scrolling rows `y' to `y + height - 1' (0-based) to the CK_SCREEN_BUFFER
+void ck_scroll(size_t y, size_t height, long amount); // Scroll rows `y' to `y + height - 1' of CK_GRID upward by `amount' rows (downward if negative), having the terminal move what's already on screen so only the new rows need drawing
+void ck_move_rows(size_t from, size_t to, size_t length); // Have the terminal move rows `from' to `from + length - 1' (0-based) to start at row `to' by deleting and inserting lines around them, doing the same to CK_GRID_DISPLAYED (rows they pass over are blanked; everything else stays put)
+void ck_detect_moves(void); // Find blocks of rows of CK_GRID_DISPLAYED that have moved vertically in CK_GRID (by matching row hashes), and have the terminal move them into place rather than them being repainted
+
+void ck_pool_start(void); // Start the pool's threads (ck_parallel_for() does this itself the first time)
+void ck_pool_end(void); // Stop the pool's threads
+void ck_parallel_for(size_t count, ck_job job, void *data); // Call `job(i, data)' for every `i' below `count', spread across the pool (and the calling thread), returning once they're all done
+void ck_present(void); // Write only the cells of CK_GRID that differ from what's on screen (moving rows that have just moved), then ck_flip()
+
+void ck_tile_init(struct ck_tile *tile, size_t x, size_t y, size_t width, size_t height, ck_tile_callback draw, void *data); // Set up a tile covering a rectangle of CK_GRID
+void ck_tile_free(struct ck_tile *tile); // Free a tile's cells
+void ck_tile_merge(const struct ck_tile *tile); // Copy a tile's cells into CK_GRID and mark them as damaged (for apps drawing tiles on their own threads)
+void ck_compose(struct ck_tile *tiles, size_t count); // Draw tiles in parallel, then merge them into CK_GRID, ready for ck_flip() (tiles mustn't overlap; cut-off double-width glyphs at their edges are the drawer's business)
+
+void ck_sprite_init(struct ck_sprite *sprite, size_t width, size_t height); // Set up a sprite that's entirely transparent until drawn into
+void ck_sprite_free(struct ck_sprite *sprite); // Free a sprite's cells and mask
+void ck_sprite_put(struct ck_sprite *sprite, size_t x, size_t y, struct ck_cell cell); // Set a cell of a sprite and make it opaque (both halves, if the glyph is double-width)
+size_t ck_sprite_text(struct ck_sprite *sprite, size_t x, size_t y, const char *text, unsigned int fg, unsigned int bg, unsigned char attr); // Write a UTF-8 string into a row of a sprite, making what it covers opaque, and returning how many columns that was
+void ck_blit(struct ck_grid *grid, const struct ck_sprite *sprite, long x, long y); // Draw the opaque cells of a sprite onto a grid with its top-left at (x, y), clipping whatever falls off the edges (rows are copied a run of opaque cells at a time)
+
+void ck_canvas_init(struct ck_canvas *canvas, size_t width, size_t height); // Set up a black canvas of `width' by `height' pixels (rounded up to an even height)
+void ck_canvas_free(struct ck_canvas *canvas); // Free a canvas's pixels
+unsigned int ck_colour_to_256(unsigned int colour); // Nearest colour to an RGB value in the 256-colour palette's 6x6x6 cube
+void ck_canvas_draw(struct ck_grid *grid, struct ck_canvas *canvas, size_t x, size_t y, int mode); // Draw a canvas onto a grid as half blocks with its top-left at cell (x, y), converting its colours as CK_CANVAS_* `mode' says (clipped to the grid; CK_CANVAS_256_DIFFUSED uses the canvas's `errors' rows, so only one thread can be drawing a canvas at a time)
+
+void ck_braille_init(struct ck_braille *braille, size_t width, size_t height); // Set up an empty braille canvas of at least `width' by `height' dots
+void ck_braille_free(struct ck_braille *braille); // Free a braille canvas's cells
+void ck_braille_clear(struct ck_braille *braille); // Clear every dot
+void ck_braille_points(struct ck_braille *braille, const float *xs, const float *ys, size_t count); // Set the dot nearest each of `count' points (skipping any off the canvas)
+void ck_braille_line(struct ck_braille *braille, long x0, long y0, long x1, long y1); // Set the dots along a line between two dots (clipped to the canvas)
+void ck_braille_polyline(struct ck_braille *braille, const float *xs, const float *ys, size_t count); // Join `count' points with lines, in order
+void ck_braille_draw(struct ck_grid *grid, const struct ck_braille *braille, size_t x, size_t y, unsigned int fg, unsigned int bg); // Draw a braille canvas onto a grid with its top-left at cell (x, y), in the given colours (clipped to the grid; empty cells become spaces)
+
+const char *ck_map_file(const char *path, size_t *size); // Map a whole file into memory read-only, setting `size' to its length (NULL if it can't be, with errno saying why on Unix-likes; the file should only be appended to while mapped, since touching a part that's been truncated away crashes with SIGBUS, so logs are best rotated by renaming)
+void ck_unmap_file(const char *data, size_t size); // Unmap a file mapped by ck_map_file()
+size_t ck_skip_lines(const char *text, size_t len, size_t count, size_t *skipped); // Where the line after the `count'th newline in `text' starts (or `len' if there aren't that many, with `skipped' set to how many there were), looking a vector at a time
+
+_Bool ck_view_open(struct ck_view *view, const char *path); // Open a file to be viewed from its first line, and start indexing its lines in the background (0 if it can't be opened, see ck_map_file())
+void ck_view_close(struct ck_view *view); // Stop indexing a view (and searching it), and unmap its file
+size_t ck_view_lines(struct ck_view *view, _Bool *complete); // How many lines have been counted so far (setting `complete' if that's all of them; can be NULL)
+size_t ck_view_line_at(struct ck_view *view, size_t offset); // Which line the char at `offset' is on (counting from the nearest checkpoint, or from the start if the index hasn't got that far)
+void ck_view_goto_line(struct ck_view *view, size_t line); // Put line `line' (from 0) at the top of the window (or the last line, if there aren't that many)
+void ck_view_goto_offset(struct ck_view *view, size_t offset); // Put the line that the char at `offset' is on at the top of the window
+void ck_view_scroll(struct ck_view *view, long amount); // Move the window down by `amount' lines (up if negative), stopping at either end of the file
+void ck_view_draw(struct ck_view *view, size_t x, size_t y, size_t width, size_t height); // Write the lines in the window to the CK_SCREEN_BUFFER, into the rectangle at (x, y) (0-based; lines are cut off at `width' columns, and anything left over is erased)
+int ck_view_reload(struct ck_view *view); // Remap the view's file if it's grown, carrying on indexing from where it got to, or start again from the top if it's been replaced (as when a log is rotated), returning 1 or 2 respectively (0 if neither)
+void ck_view_update(struct ck_view *view); // ck_view_reload(), and if the window was showing the end of the file, keep it there by scrolling what's on screen up and writing only the new lines (a window that isn't the full width of CK_GRID gets rewritten instead, since the terminal can only scroll whole rows, as does any window while CK_GRID hasn't been sized)
+size_t ck_find(const char *text, size_t len, const char *needle, size_t needleLen); // Where the first `needle' in `text' starts (or `len' if there isn't one), checking a vector's worth of places at a time for its first and last chars before comparing the rest
+void ck_search_start(struct ck_search *search, struct ck_view *view, const char *needle, size_t len); // Start searching a view's file for `len' chars of `needle' in the background, and have ck_view_draw() highlight the matches (reversed; change `highlight' for something else), stopping any search already on it
+void ck_search_stop(struct ck_search *search); // Stop a search and free its matches (the view goes back to not highlighting anything)
+size_t ck_search_count(struct ck_search *search, _Bool *complete); // How many matches have been found so far (setting `complete' if that's all of them; can be NULL)
+size_t ck_search_match(const struct ck_search *search, size_t i); // Where match `i' starts (`i' must be below ck_search_count())
+size_t ck_search_next(struct ck_search *search, size_t offset); // Which is the first match found so far that starts at or after `offset' (ck_search_count() if none)
+
+void ck_table_init(struct ck_table *table, size_t columns, ck_table_callback cell, void *data); // Set up an empty table with `columns' columns, whose cells' text comes from `cell' (asked for row CK_TABLE_HEADER to get the titles)
+void ck_table_free(struct ck_table *table);
+void ck_table_resize(struct ck_table *table, size_t rows); // Change how many rows a table has (new ones are measured and go at the end, whatever order it's in)
+void ck_table_changed(struct ck_table *table, size_t row); // Measure a row again after its text has changed (or the titles, for CK_TABLE_HEADER)
+void ck_table_sort(struct ck_table *table, ck_table_compare compare, void *data); // Put a table's rows in order by `compare' (rows that compare equal keep the order they were in, so sorting by one column then another sorts by both), without moving them
+void ck_table_scroll(struct ck_table *table, long amount); // Move the window down by `amount' rows (up if negative), stopping at either end of the table
+void ck_table_draw(struct ck_table *table, size_t x, size_t y, size_t width, size_t height); // Write the titles and the rows in the window to the CK_SCREEN_BUFFER, into the rectangle at (x, y) (0-based; cells are cut off at the width of their column, and the row at that of the rectangle)
+
+void ck_progress_init(struct ck_progress *progress, size_t count); // Set up `count' progress bars (with no labels, and totals of 100)
+void ck_progress_free(struct ck_progress *progress);
+void ck_progress_scroll(struct ck_progress *progress, long amount); // Move the window down by `amount' bars (up if negative), stopping at either end (call ck_progress_draw() again after)
+void ck_progress_draw(struct ck_progress *progress, size_t x, size_t y, size_t width, size_t height); // Write the bars in the window to the CK_SCREEN_BUFFER, into the rectangle at (x, y) (0-based; if they don't all fit, the bottom row sums up the ones that don't)
+void ck_progress_recount(struct ck_progress_bar *bar); // Bring a bar's share of its ck_progress's running totals up to date (ck_progress_add() and the like do this themselves)
+void ck_progress_update(struct ck_progress *progress); // Write only the parts of the window that have changed since it was last drawn (bars whose filled-in width or percentage is different, and the summary line if its text is), to be called at a fixed rate however often the tasks update
+
+size_t ck_parse_input(const char *in, size_t len, struct ck_event *event); // Decode the key at the start of `in', returning how many chars it took up (0 if it's incomplete)
+void ck_decode_input(const char *bytes, size_t len, ck_event_callback callback, void *data); // Add input read from the terminal to CK_INPUT_BUFFER (`bytes' can be NULL if it was read straight in), and pass each event decoded from it to `callback' (anything incomplete is kept until the rest arrives)
+
+#ifndef _WIN32
+
+_Bool ck_poll_event(struct ck_event *event); // Take the next event from the input thread, if there is one (never blocks, locks, or makes a system call; a paste's text is valid until the next call)
+void ck_start_input_thread(void); // Start a thread that reads and decodes input for ck_poll_event() (it owns CK_INPUT_BUFFER while running, so don't use ck_run() at the same time)
+void ck_stop_input_thread(void); // Stop the thread started by ck_start_input_thread() (events it has already queued can still be taken)
+
+#endif
+
+#ifdef __linux__
+
+void ck_on_event(ck_event_callback callback, void *data); // Set what gets called for input and resizes while ck_run() is running
+void ck_add_fd(int fd, ck_fd_callback callback, void *data); // Have `callback' called whenever `fd' is readable while ck_run() is running
+void ck_remove_fd(int fd); // Stop watching an fd added with ck_add_fd() (or a timer from ck_add_timer(), which also gets closed)
+int ck_add_timer(unsigned int interval, ck_timer_callback callback, void *data); // Have `callback' called every `interval' ms while ck_run() is running (missed ticks are merged into one), returning the timer to pass to ck_remove_timer()
+void ck_stop(void); // Have ck_run() return once it's finished dispatching what's ready
+void ck_loop_start(void); // Get ready to dispatch events (ck_run() does this itself; only needed for driving things with ck_process_ready() from another event loop)
+void ck_loop_end(void); // Put things back the way they were before ck_loop_start()
+int ck_wait_and_dispatch(int timeout); // Wait up to `timeout' ms (-1 for as long as it takes) for anything to be ready and dispatch it, returning how many things were
+void ck_run(void); // Wait for input, resizes, timers, and added fds, calling their callbacks, until ck_stop() is called (nothing is done in between, so it's idle while there's nothing to do)
+
+_Bool ck_view_follow(struct ck_view *view, unsigned int interval); // Like `tail -f': while ck_run() is running, ck_view_update() and ck_flip() within `interval' ms of the view's file being written to (everything written in between shows up in the same frame), returning 0 if the file can't be watched
+void ck_view_unfollow(struct ck_view *view); // Stop following a view's file (ck_view_close() does this itself)
+
+void ck_progress_start(struct ck_progress *progress, unsigned int interval); // While ck_run() is running, ck_progress_update() and ck_flip() every `interval' ms
+void ck_progress_stop(struct ck_progress *progress); // Stop redrawing progress bars (ck_progress_free() does this itself)
+
+#endif
+
+// Small functions that get called all the time, defined here so they can be inlined into callers:
+
+static inline void ck_write(const char *buffer, size_t len) { // Write `len' bytes of `buffer' to the CK_SCREEN_BUFFER (doesn't need to be \0-terminated)
+    if(CK_SCREEN_BUFFER_END + len + 1 > CK_SCREEN_BUFFER_SIZE) // Automatic reallocation if needed
+        ck_grow_screen_buffer(len);
+
+    memcpy(CK_SCREEN_BUFFER + CK_SCREEN_BUFFER_END, buffer, len);
+
+    CK_SCREEN_BUFFER[CK_SCREEN_BUFFER_END += len] = '\0';
+}
+
+static inline void ck_print(const char *buffer) { // Write a string to the CK_SCREEN_BUFFER
+    ck_write(buffer, strlen(buffer));
+}
+
+static inline struct ck_cell ck_grid_get(const struct ck_grid *grid, size_t index) { // The cell at `index' of the grid's arrays
+    return (struct ck_cell){grid->glyph[index], grid->fg[index], grid->bg[index], grid->attr[index]};
+}
+
+static inline void ck_grid_store(struct ck_grid *grid, size_t index, struct ck_cell cell) { // Set the cell at `index' of the grid's arrays (as is, so double-width glyphs and the row's hash are up to the caller)
+    grid->glyph[index] = cell.glyph,
+    grid->fg[index] = cell.fg,
+    grid->bg[index] = cell.bg,
+    grid->attr[index] = cell.attr;
+}
+
+static inline void ck_grid_copy(struct ck_grid *to, size_t toIndex, const struct ck_grid *from, size_t fromIndex, size_t count) { // Copy `count' cells from `fromIndex' of one grid to `toIndex' of another (or the same one, overlapping or not)
+    memmove(to->glyph + toIndex, from->glyph + fromIndex, count * sizeof(unsigned int)),
+    memmove(to->fg + toIndex, from->fg + fromIndex, count * sizeof(unsigned int)),
+    memmove(to->bg + toIndex, from->bg + fromIndex, count * sizeof(unsigned int)),
+    memmove(to->attr + toIndex, from->attr + fromIndex, count * sizeof(unsigned char));
+}
+
+static inline _Bool ck_grid_cells_equal(const struct ck_grid *a, size_t aIndex, const struct ck_grid *b, size_t bIndex) { // Compare a cell of one grid with a cell of another (or the same one)
+    return a->glyph[aIndex] == b->glyph[bIndex] && a->fg[aIndex] == b->fg[bIndex] && a->bg[aIndex] == b->bg[bIndex] && a->attr[aIndex] == b->attr[bIndex];
+}
+
+static inline void ck_progress_add(struct ck_progress_bar *bar, size_t amount) { // Add to how much of a task is done (from any thread)
+    atomic_fetch_add_explicit(&bar->done, amount, memory_order_relaxed);
+    ck_progress_recount(bar);
+}
+
+static inline void ck_progress_set(struct ck_progress_bar *bar, size_t amount) { // Set how much of a task is done (from any thread)
+    atomic_store_explicit(&bar->done, amount, memory_order_relaxed);
+    ck_progress_recount(bar);
+}
+
+static inline void ck_progress_set_total(struct ck_progress_bar *bar, size_t amount) { // Set how much there is to do (from any thread)
+    atomic_store_explicit(&bar->total, amount, memory_order_relaxed);
+    ck_progress_recount(bar);
+}
+
+static inline size_t ck_utf8_encode(unsigned int glyph, char *out) { // Write the UTF-8 encoding of `glyph' to `out' (up to 4 chars, not \0-terminated), returning its length
+    if(glyph < 0x80)
+        return out[0] = glyph, 1;
+
+    if(glyph < 0x800)
+        return out[0] = 0xC0 | glyph >> 6,
+               out[1] = 0x80 | (glyph & 0x3F), 2;
+
+    if(glyph < 0x10000)
+        return out[0] = 0xE0 | glyph >> 12,
+               out[1] = 0x80 | (glyph >> 6 & 0x3F),
+               out[2] = 0x80 | (glyph & 0x3F), 3;
+
+    return out[0] = 0xF0 | (glyph >> 18 & 0x7),
+           out[1] = 0x80 | (glyph >> 12 & 0x3F),
+           out[2] = 0x80 | (glyph >> 6 & 0x3F),
+           out[3] = 0x80 | (glyph & 0x3F), 4;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#if defined(CK_IMPLEMENTATION) && !defined(CONKIT_IMPLEMENTATION) // Everything else, for the one file that defines CK_IMPLEMENTATION
+#define CONKIT_IMPLEMENTATION
+
+#if defined(__AVX2__) // Text scanning uses whichever vector instructions are being compiled for
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Globals:
+
+size_t CK_SCREEN_BUFFER_SIZE,
+       CK_SCREEN_BUFFER_END;
+
+char *CK_SCREEN_BUFFER,
+     *CK_SEQUENCE_BUFFER;
+
+void *CK_ALLOC_BUFFER;
+
+struct ck_grid CK_GRID,
+               CK_GRID_DISPLAYED;
+
+size_t CK_DAMAGE_BUFFER_SIZE,
+       CK_DAMAGE_BUFFER_END;
+
+struct ck_rect *CK_DAMAGE_BUFFER;
+
+size_t CK_BAND_BUFFER_SIZE,
+       CK_BAND_BUFFER_END;
+
+struct ck_segment *CK_BAND_BUFFER;
+
+unsigned int CK_CAPABILITIES;
+
+size_t CK_INPUT_BUFFER_SIZE,
+       CK_INPUT_BUFFER_END;
+
+char *CK_INPUT_BUFFER;
+
+size_t CK_PASTE_SEARCHED;
+
+unsigned long long CK_INPUT_READ_TIME;
+
+unsigned long long CK_LATENCY_BUFFER[CK_LATENCY_SAMPLES],
+                   CK_LATENCY_PENDING;
+
+size_t CK_LATENCY_COUNT;
+
+// Implementation-specific definitions:
+
+#ifdef _WIN32 // Windows
+
+HANDLE CK_STD_OUTPUT_HANDLE;
+DWORD CK_CONSOLE_MODE;
+
+void ck_init(void) { // Initialise ck
+    // Enable ANSI escape sequences ("VIRTUAL_TERMINAL_PROCESSING"):
+
+    CK_STD_OUTPUT_HANDLE = GetStdHandle(STD_OUTPUT_HANDLE);
+    GetConsoleMode(CK_STD_OUTPUT_HANDLE, &CK_CONSOLE_MODE);
+    SetConsoleMode(CK_STD_OUTPUT_HANDLE, CK_CONSOLE_MODE | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    
+    // Allocate memory for CK_SCREEN_BUFFER:
+    
+    if((CK_SCREEN_BUFFER = (char *)calloc(CK_SCREEN_BUFFER_SIZE = CK_ALLOC_SIZE, sizeof(char))) == NULL) {
+        perror("Error allocating memory for CK_SCREEN_BUFFER: ");
+        exit(EXIT_FAILURE);
+    }
+
+    // Initialise CK_SCREEN_BUFFER:
+    
+    CK_SCREEN_BUFFER_END = 0;
+    memset(CK_SCREEN_BUFFER, '\0', CK_ALLOC_SIZE);
+    
+    // Allocate memory for CK_SEQUENCE_BUFFER:
+    
+    if((CK_SEQUENCE_BUFFER = (char *)calloc(2 * (log10(pow(2, sizeof(size_t) * 8) - 1) + 1) + 21, sizeof(char))) == NULL) { // Max length of a size_t in digits for base-10, times two because for one of the functions there is two size_t needed, plus 20 because the rgb function requires a 20 character string, plus 1 for \0
+        perror("Error allocating memory for CK_SEQUENCE_BUFFER: ");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void ck_end(void) { // End usage of ck and put things back to normal
+    SetConsoleMode(CK_STD_OUTPUT_HANDLE, CK_CONSOLE_MODE); // Set console back to the way it was (don't leave them with escape codes enabled if that's how they were originally)
+
+    ck_pool_end(); // (Before the grids its threads work on go)
+
+    // Free allocated memory:
+    
+    free(CK_SCREEN_BUFFER);
+    free(CK_SEQUENCE_BUFFER);
+    ck_grid_free(&CK_GRID);
+    ck_grid_free(&CK_GRID_DISPLAYED);
+    free(CK_DAMAGE_BUFFER);
+    free(CK_INPUT_BUFFER);
+
+    while(CK_BAND_BUFFER_SIZE)
+        free(CK_BAND_BUFFER[--CK_BAND_BUFFER_SIZE].buffer);
+
+    free(CK_BAND_BUFFER);
+}
+
+unsigned int ck_probe_capabilities(void) { // Find out which optional sequences the terminal supports (reading its replies back isn't supported on Windows yet, so nothing is assumed)
+    return CK_CAPABILITIES;
+}
+
+struct ck_console_size ck_current_console_size(void) { // Get current terminal dimensions
+    size_t newWidth, newHeight;
+
+    static struct ck_console_size knownSize = {0, 0, 0};
+    CONSOLE_SCREEN_BUFFER_INFO currentBufferInfo;
+
+    // Get the info:
+    
+    GetConsoleScreenBufferInfo(CK_STD_OUTPUT_HANDLE, &currentBufferInfo);
+
+    // Work out dimensions:
+    
+    newWidth = currentBufferInfo.srWindow.Right - currentBufferInfo.srWindow.Left + 1,
+    newHeight = currentBufferInfo.srWindow.Bottom - currentBufferInfo.srWindow.Top + 1;
+
+    // Modify return value if they differ from what's already known:
+    
+    if((knownSize.has_changed = newWidth != knownSize.width || newHeight != knownSize.height))
+        knownSize.width = newWidth,
+        knownSize.height = newHeight;
+
+    return knownSize;
+}
+
+void ck_output_frame(const struct ck_segment *segments, size_t count) { // Write the cursor home, CK_SCREEN_BUFFER, and then `count' segments to the console
+    size_t i;
+
+    fputs("\033[H", stdout);
+    fwrite(CK_SCREEN_BUFFER, sizeof(char), CK_SCREEN_BUFFER_END, stdout);
+
+    for(i = 0; i < count; i++)
+        fwrite(segments[i].buffer, sizeof(char), segments[i].end, stdout);
+
+    fflush(stdout); // Partial updates often don't end in a newline, so wouldn't otherwise show up
+}
+
+unsigned long long ck_now(void) { // Current time from a monotonic clock, in ns
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+
+    if(!frequency.QuadPart)
+        QueryPerformanceFrequency(&frequency);
+
+    QueryPerformanceCounter(&now);
+
+    return now.QuadPart / frequency.QuadPart * 1000000000ULL + now.QuadPart % frequency.QuadPart * 1000000000ULL / frequency.QuadPart;
+}
+
+struct ck_thread_args { // What a thread was started with, since Windows threads take a different kind of function
+    void *(*function)(void *);
+    void *arg;
+};
+
+static DWORD WINAPI ck_thread_trampoline(LPVOID args) { // Call a thread's actual function
+    struct ck_thread_args start = *(struct ck_thread_args *)args;
+
+    free(args);
+    start.function(start.arg);
+
+    return 0;
+}
+
+ck_thread ck_thread_start(void *(*function)(void *), void *arg) { // Start a thread running `function(arg)'
+    struct ck_thread_args *args;
+    ck_thread thread;
+
+    if((args = (struct ck_thread_args *)malloc(sizeof(struct ck_thread_args))) == NULL) {
+        perror("Error allocating memory for thread: ");
+        exit(EXIT_FAILURE);
+    }
+
+    args->function = function,
+    args->arg = arg;
+
+    if((thread = CreateThread(NULL, 0, ck_thread_trampoline, args, 0, NULL)) == NULL) {
+        fprintf(stderr, "Error starting thread\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return thread;
+}
+
+void ck_thread_join(ck_thread thread) { // Wait for a thread to finish
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+size_t ck_cpu_count(void) { // How many processors there are to run threads on
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors;
+}
+
+const char *ck_map_file(const char *path, size_t *size) { // Map a whole file into memory read-only, setting `size' to its length (NULL if it can't be, with errno saying why on Unix-likes)
+    HANDLE file, mapping;
+    LARGE_INTEGER length;
+    const char *data;
+
+    if((file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    if(!GetFileSizeEx(file, &length)) {
+        CloseHandle(file);
+
+        return NULL;
+    }
+
+    if(!(*size = (size_t)length.QuadPart)) { // Empty files can't be mapped, but there's nothing to map anyway
+        CloseHandle(file);
+
+        return "";
+    }
+
+    // The view keeps the file mapped after the handles are closed:
+
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+
+    if(mapping == NULL)
+        return NULL;
+
+    data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    return data;
+}
+
+void ck_unmap_file(const char *data, size_t size) { // Unmap a file mapped by ck_map_file()
+    if(size)
+        UnmapViewOfFile(data);
+}
+
+// Unix-like:
+
+#elif defined(unix) || \
+      defined(__unix) || \
+      defined(__unix__) || \
+      defined(__APPLE__) || \
+      defined(__MACH__)
+
+#include <termios.h> // For disabling input echo and buffering
+#include <poll.h> // To poll stdin for my implementation of kbhit()
+#include <sys/ioctl.h> // To get terminal dimensions
+#include <errno.h> // For what went wrong
+#include <time.h> // For clock_gettime()
+#include <sys/uio.h> // For writev()
+#include <sys/mman.h> // For mapping files into memory
+#include <sys/stat.h> // For files' sizes
+#include <fcntl.h> // For open()
+#include <signal.h> // For blocking SIGWINCH (in conkit's own threads, and so it can be read from a signalfd)
+
+#ifndef CLOCK_MONOTONIC // _DEFAULT_SOURCE came too late (see the top), so ck_now() couldn't be a monotonic clock
+#error conkit.h has to be included before any system header in the file that defines CK_IMPLEMENTATION
+#endif
+
+struct termios CK_CONSOLE_SETTS,
+               CK_CONSOLE_ORIG_SETTS;
+
+char getch(void) { // My implementation of the getch() function
+    char ret;
+
+    // Change settings, get char, revert settings, return value:
+    
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_SETTS);
+
+    ret = getchar();
+
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_ORIG_SETTS);
+
+    return ret;
+}
+
+_Bool kbhit(void) { // My own implementation of the kbhit() function
+    static struct pollfd fd_buff[] = {{.fd = STDIN_FILENO, // File descriptor for stdin
+                                       .events = POLLIN,
+                                       .revents = 0}};
+
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_SETTS); // Set non-echo, non-buffering settings
+
+    poll(fd_buff, 1, 0); // Poll the items in the file descriptor array, waiting 0s for each (since kbhit() will be called to check if the keyboard has *been* hit, not to wait for it to *be* hit)
+
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_ORIG_SETTS); // Revert settings
+
+    return fd_buff[0].revents & POLLIN; // So, was there input?
+}
+
+void ck_init(void) { // Initialise ck
+    // Pre-compute unechoed-and-unbuffered-input attributes (and original attributes) so they can be readily applied:
+
+    tcgetattr(0, &CK_CONSOLE_ORIG_SETTS);
+    CK_CONSOLE_SETTS = CK_CONSOLE_ORIG_SETTS;
+
+    CK_CONSOLE_SETTS.c_lflag &= ~ECHO & ~ICANON;
+
+    // Allocate memory for CK_SCREEN_BUFFER:
+
+    if((CK_SCREEN_BUFFER = (char *)calloc(CK_SCREEN_BUFFER_SIZE = CK_ALLOC_SIZE, sizeof(char))) == NULL) {
+        perror("Error allocating memory for CK_SCREEN_BUFFER: ");
+        exit(EXIT_FAILURE);
+    }
+
+    // Initialise CK_SCREEN_BUFFER:
+    
+    CK_SCREEN_BUFFER_END = 0;
+    memset(CK_SCREEN_BUFFER, '\0', CK_ALLOC_SIZE);
+    
+    // Allocate memory for CK_SEQUENCE_BUFFER:
+    
+    if((CK_SEQUENCE_BUFFER = (char *)calloc(2 * (log10(pow(2, sizeof(size_t) * 8) - 1) + 1) + 21, sizeof(char))) == NULL) { // Max length of a size_t in digits for base-10, times two because for one of the functions there is two size_t needed, plus 20 because the rgb function requires a 20 character string, plus 1 for \0
+        perror("Error allocating memory for CK_SEQUENCE_BUFFER: ");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void ck_end(void) { // End usage of ck and put things back to normal
+    ck_pool_end(); // (Before the grids its threads work on go)
+
+    // Free allocated memory:
+
+    free(CK_SCREEN_BUFFER);
+    free(CK_SEQUENCE_BUFFER);
+    ck_grid_free(&CK_GRID);
+    ck_grid_free(&CK_GRID_DISPLAYED);
+    free(CK_DAMAGE_BUFFER);
+    free(CK_INPUT_BUFFER);
+
+    while(CK_BAND_BUFFER_SIZE)
+        free(CK_BAND_BUFFER[--CK_BAND_BUFFER_SIZE].buffer);
+
+    free(CK_BAND_BUFFER);
+}
+
+static _Bool ck_probe_position(unsigned int *column) { // Ask the terminal where the cursor is, setting `column' (1-based) if it answers in time
+    static struct pollfd fd_buff[] = {{.fd = STDIN_FILENO,
+                                       .events = POLLIN,
+                                       .revents = 0}};
+    char reply[32];
+    size_t len = 0;
+    unsigned int row;
+
+    printf("\033[6n");
+    fflush(stdout);
+
+    while(len < sizeof(reply) - 1 && poll(fd_buff, 1, CK_PROBE_TIMEOUT) > 0 && read(STDIN_FILENO, reply + len, 1) == 1 && reply[len++] != 'R');
+
+    reply[len] = '\0';
+
+    return sscanf(reply, "\033[%u;%uR", &row, column) == 2;
+}
+
+unsigned int ck_probe_capabilities(void) { // Find out which optional sequences the terminal supports, setting (and returning) CK_CAPABILITIES (only the cells it writes to test with get blanked, wherever the cursor is, and the cursor's put back)
+    struct winsize dims;
+    unsigned int start, column;
+
+    if(!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) // Nobody to ask
+        return CK_CAPABILITIES;
+
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_SETTS); // The replies shouldn't be echoed or wait for a newline
+
+    if(ck_probe_position(&start)) {
+        printf("\0337"); // Save the cursor, to put it back after
+
+        // Two cells' room is needed, so the second `X' can't wrap (or scroll) onto the next line:
+
+        if(!ioctl(STDOUT_FILENO, TIOCGWINSZ, &dims) && dims.ws_col >= 3 && start + 2 > dims.ws_col)
+            printf("\033[%uG", start = dims.ws_col - 2);
+
+        // A terminal that understands REP prints the `X' twice, which shows in the cursor position it reports back:
+
+        printf("X\033[1b");
+
+        if(ck_probe_position(&column))
+            CK_CAPABILITIES = column == start + 2 ? CK_CAPABILITIES | CK_CAP_REP : CK_CAPABILITIES & ~CK_CAP_REP;
+        else
+            column = start + 2; // (Assume the worst about what got written)
+
+        printf("\033[%uG\033[%uX\0338", start, column > start ? column - start : 1); // Clean up after ourselves, blanking just those cells
+        fflush(stdout);
+    }
+
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_ORIG_SETTS);
+
+    return CK_CAPABILITIES;
+}
+
+struct ck_console_size ck_current_console_size(void) { // Get current terminal dimensions
+    struct winsize newDims;
+
+    static struct ck_console_size knownSize = {0, 0, 0};
+    
+    // Get the dimensions:
+    
+    ioctl(0, TIOCGWINSZ, &newDims);
+    
+    // Modify return value if they differ from what's already known:
+    
+    if((knownSize.has_changed = newDims.ws_col != knownSize.width || newDims.ws_row != knownSize.height))
+        knownSize.width = newDims.ws_col,
+        knownSize.height = newDims.ws_row;
+
+    return knownSize;
+}
+
+#define CK_OUTPUT_VECTORS 64 /* Most pieces of a frame handed to writev() at once */
+
+void ck_output_frame(const struct ck_segment *segments, size_t count) { // Write the cursor home, CK_SCREEN_BUFFER, and then `count' segments to the terminal, in a single writev() unless there are loads of segments
+    struct iovec vectors[CK_OUTPUT_VECTORS];
+    size_t used = 0,
+           done,
+           i = 0;
+    ssize_t written;
+
+    fflush(stdout); // Anything printf()ed has to come first
+
+    vectors[used++] = (struct iovec){.iov_base = (char *)"\033[H", .iov_len = 3},
+    vectors[used++] = (struct iovec){.iov_base = CK_SCREEN_BUFFER, .iov_len = CK_SCREEN_BUFFER_END};
+
+    do {
+        for(; i < count && used < CK_OUTPUT_VECTORS; i++)
+            if(segments[i].end)
+                vectors[used++] = (struct iovec){.iov_base = segments[i].buffer, .iov_len = segments[i].end};
+
+        // Terminals can take less than everything at once, so carry on from wherever it stopped:
+
+        while(used) {
+            if((written = writev(STDOUT_FILENO, vectors, used)) < 0) {
+                if(errno == EINTR)
+                    continue;
+
+                return; // Nowhere to tell anyone about it (stdout is broken), same as fwrite() failing
+            }
+
+            for(done = 0; done < used && (size_t)written >= vectors[done].iov_len; done++)
+                written -= vectors[done].iov_len;
+
+            if(done < used)
+                vectors[done].iov_base = (char *)vectors[done].iov_base + written,
+                vectors[done].iov_len -= written;
+
+            memmove(vectors, vectors + done, (used -= done) * sizeof(struct iovec));
+        }
+    } while(i < count);
+}
+
+unsigned long long ck_now(void) { // Current time from a monotonic clock, in ns
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+ck_thread ck_thread_start(void *(*function)(void *), void *arg) { // Start a thread running `function(arg)' (with SIGWINCH blocked, so a resize always goes to the thread reading it, not one of these where it'd be thrown away)
+    ck_thread thread;
+    sigset_t resize, original;
+
+    // It starts with the signal mask of the thread starting it:
+
+    sigemptyset(&resize);
+    sigaddset(&resize, SIGWINCH);
+    pthread_sigmask(SIG_BLOCK, &resize, &original);
+
+    if((errno = pthread_create(&thread, NULL, function, arg))) {
+        perror("Error starting thread: ");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &original, NULL);
+
+    return thread;
+}
+
+void ck_thread_join(ck_thread thread) { // Wait for a thread to finish
+    pthread_join(thread, NULL);
+}
+
+size_t ck_cpu_count(void) { // How many processors there are to run threads on
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? count : 1;
+}
+
+const char *ck_map_file(const char *path, size_t *size) { // Map a whole file into memory read-only, setting `size' to its length (NULL if it can't be, with errno saying why on Unix-likes)
+    struct stat info;
+    void *data;
+    int fd, error;
+
+    if((fd = open(path, O_RDONLY)) < 0)
+        return NULL;
+
+    if(fstat(fd, &info) < 0) {
+        error = errno;
+        close(fd);
+        errno = error;
+
+        return NULL;
+    }
+
+    if(!(*size = info.st_size)) { // Empty files can't be mapped, but there's nothing to map anyway
+        close(fd);
+
+        return "";
+    }
+
+    // The mapping stays after the fd is closed:
+
+    data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0),
+    error = errno;
+    close(fd);
+    errno = error;
+
+    return data == MAP_FAILED ? NULL : (const char *)data;
+}
+
+void ck_unmap_file(const char *data, size_t size) { // Unmap a file mapped by ck_map_file()
+    if(size)
+        munmap((void *)data, size);
+}
+
+#else // RIP (maybe support later)
+
+#error Could not be determined if system is Unix-like or Windows! I do not know how I should be implemented! Please `#define unix', or `#define _WIN32'.
+
+#endif
+
+// Non-implementation-specific function definitions:
+
+char *ck_rgb(unsigned char where, // Generate ANSI escape-sequence string for specified RGB value
+             unsigned char r,
+             unsigned char g,
+             unsigned char b) {
+
+    sprintf(CK_SEQUENCE_BUFFER,
+            "\033[%d;2;%d;%d;%dm",
+            where,
+            r, g, b);
+    
+    return CK_SEQUENCE_BUFFER;
+}
+
+char *ck_cursor_goto(size_t x, size_t y) { // Generate ANSI escape-sequence string for cursor movement to specified co-ordinates
+    sprintf(CK_SEQUENCE_BUFFER, "\033[%zu;%zuH", y, x);
+
+    return CK_SEQUENCE_BUFFER;
+}
+
+char *ck_cursor_move(char where, size_t amount) { // Generate ANSI escape-sequence string for cursor movement in a direction relative-to current position
+    sprintf(CK_SEQUENCE_BUFFER, "\033[%zu%c", amount, where);
+
+    return CK_SEQUENCE_BUFFER;
+}
+
+char *ck_scroll_region(size_t top, size_t bottom) { // Generate ANSI escape-sequence string for restricting scrolling to lines `top' to `bottom' (inclusive)
+    sprintf(CK_SEQUENCE_BUFFER, "\033[%zu;%zur", top, bottom);
+
+    return CK_SEQUENCE_BUFFER;
+}
+
+// Other functions:
+
+void ck_grow_screen_buffer(size_t len) { // Make room for `len' more chars (and a \0) at the end of the CK_SCREEN_BUFFER (ck_write() only calls this when there isn't, so it can stay small enough to inline)
+    while(CK_SCREEN_BUFFER_END + len + 1 > CK_SCREEN_BUFFER_SIZE) // Calculate new size (grows geometrically, since grid output is written a few bytes at a time)
+        CK_SCREEN_BUFFER_SIZE += CK_SCREEN_BUFFER_SIZE > CK_ALLOC_SIZE ? CK_SCREEN_BUFFER_SIZE : CK_ALLOC_SIZE;
+
+    if((CK_ALLOC_BUFFER = (void *)realloc(CK_SCREEN_BUFFER, CK_SCREEN_BUFFER_SIZE * sizeof(char))) == NULL) { // Reallocate
+        perror("Error reallocating memory for CK_SCREEN_BUFFER: ");
+
+        free(CK_SCREEN_BUFFER);
+        free(CK_SEQUENCE_BUFFER);
+
+        exit(EXIT_FAILURE);
+    }
+
+    CK_SCREEN_BUFFER = (char *)CK_ALLOC_BUFFER;
+}
+
+void ck_segment_write(struct ck_segment *segment, const char *buffer, size_t len) { // Write `len' bytes of `buffer' to the end of `segment' (or to the CK_SCREEN_BUFFER if it's NULL)
+    char *grown; // Not CK_ALLOC_BUFFER, since segments can be written on several threads at once
+
+    if(!segment) {
+        ck_write(buffer, len);
+        return;
+    }
+
+    // Automatic reallocation if needed:
+
+    if(segment->end + len > segment->size) {
+        while(segment->end + len > segment->size)
+            segment->size += segment->size > CK_ALLOC_SIZE ? segment->size : CK_ALLOC_SIZE;
+
+        if((grown = (char *)realloc(segment->buffer, segment->size * sizeof(char))) == NULL) {
+            perror("Error reallocating memory for a ck_segment: ");
+            exit(EXIT_FAILURE);
+        }
+
+        segment->buffer = grown;
+    }
+
+    memcpy(segment->buffer + segment->end, buffer, len);
+    segment->end += len;
+}
+
+// Cell grid functions:
+
+// Display widths, 2 bits per code point (0 for combining marks and controls, 2 for East Asian wide/fullwidth glyphs, otherwise 1), in blocks of 256 code points that are shared between ranges with the same widths.
+// Indexed by code point / 256 up to U+3FFFF, then the two blocks from U+E0000 (anything else is 1 wide). Generated from Unicode 14.0 data:
+
+static const unsigned char CK_WIDTH_INDEX[1026] = {
+    0, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 1, 17, 1, 1, 1, 18, 19, 20, 21, 22, 23, 24, 1, 1,
+    25, 1, 1, 26, 1, 27, 28, 29, 1, 1, 1, 30, 31, 32, 33, 34,
+    35, 36, 37, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 39, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 40, 1, 41, 1, 42, 43, 44, 45, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 46, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 38, 47, 48, 1, 1, 49, 50,
+    1, 51, 52, 53, 1, 1, 1, 1, 1, 1, 54, 1, 1, 55, 56, 57,
+    58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 1, 69, 70, 71, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 72, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 73, 74, 1, 1, 1, 75,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 76, 38, 38, 38, 38, 77, 78, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 79,
+    38, 80, 81, 1, 1, 1, 1, 1, 1, 1, 1, 1, 82, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 83,
+    1, 84, 85, 1, 1, 1, 1, 1, 1, 1, 86, 1, 1, 1, 1, 1,
+    87, 74, 88, 1, 1, 1, 1, 1, 89, 90, 1, 1, 1, 1, 1, 1,
+    91, 92, 93, 94, 95, 96, 97, 98, 1, 99, 100, 1, 1, 1, 1, 1,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 101,
+    102, 103,
+};
+
+static const unsigned char CK_WIDTH_BLOCKS[104][64] = {
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x41,0x10,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x00,0x00,0x40,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x00,0x00,0x00,0x55,0x55,0x55,0x55,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x14,0x00,0x14,0x04,0x50,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x00,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x55,0x55,0x51},
+    {0x55,0x55,0x55,0x55,0x55,0x05,0x10,0x00,0x00,0x01,0x01,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x00,0x00,0x00,0x00,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    {0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x54,0x01,0x00,0x54,0x51,0x01,0x00,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x54,0x01,0x54,0x55,0x51,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x45},
+    {0x41,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x54,0x41,0x15,0x14,0x50,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x51,0x55,0x55,0x41,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x54,0x01,0x10,0x54,0x51,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x05,0x00},
+    {0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x14,0x01,0x54,0x55,0x51,0x55,0x41,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x54,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x54,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x04,0x54,0x05,0x04,0x50,0x55,0x41,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x14,0x55,0x45,0x55,0x50,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x54,0x01,0x54,0x55,0x51,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x55,0x05,0x44,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x00,0x40,0x55,0x55,0x15,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x00,0x00,0x54,0x55,0x55,0x00,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x11,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x00,0x00,0x40,0x00,0x04,0x55,0x01,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x54,0x55,0x45,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x04,0x00,0x41,0x41,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x05,0x54,0x55,0x55,0x55,0x01,0x54,0x55,0x55,0x45,0x41,0x55,0x51,0x55,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x05,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x10,0x00,0x50,0x55,0x45,0x01,0x00,0x00,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x15,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x41,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x40,0x15,0x54,0x55,0x45,0x55,0x01,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x15,0x14,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x00,0x40,0x44,0x01,0x00,0x54,0x15,0x00,0x00,0x14,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x04,0x40,0x54,0x45,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x55,0x55,0x55,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x50,0x10,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x50,0x11,0x50,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x40,0x00,0x00,0x00,0x04,0x00,0x54,0x51,0x55,0x54,0x50,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    {0x55,0x55,0x15,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x04,0x00,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x54,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0x55,0x55,0x69,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0x56,0x96,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x69},
+    {0x55,0x55,0x55,0x55,0x55,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x55,0x55,0x55,0x55,0x95,0x55,0x55,0x55,0x59,0x55,0xA5,0x55,0x55,0x55,0x55,0x69,0x55,0x5A,0x55,0x65,0x55,0x56,0x55,0x55,0x55,0x55,0x65,0x55,0xA5,0x59,0x65,0x59},
+    {0x55,0x59,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x66,0x95,0x9A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0x55,0x55,0x55,0x55,0x55,0x55,0x56,0x55,0x55,0x95,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x56,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x50,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x9A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x0A,0xA0,0xAA,0xAA,0xAA,0x6A,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0x81,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA},
+    {0x55,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x56,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x40,0x00,0x00,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x55,0x55,0x55},
+    {0x45,0x45,0x15,0x55,0x55,0x55,0x55,0x55,0x55,0x41,0x55,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x50,0x55,0x55,0x15},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x50,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x50,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x56,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x05,0x50,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x40,0x41,0x41,0x55,0x55,0x15,0x55,0x55,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x04,0x14,0x54,0x05,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x55,0x45,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x54,0x51,0x55,0x55,0x55,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x00,0x00,0x00,0x00,0xAA,0xAA,0x5A,0x55,0x00,0x00,0x00,0x00,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0xAA,0xAA,0xAA,0xAA,0x6A,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15},
+    {0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x6A,0x55,0x55,0x55,0x55,0x01,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x01,0x41,0x55,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x40,0x15,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x41,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x00,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x14,0x54,0x55,0x15,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x40,0x41,0x55,0x45,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x01,0x00,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x55,0x55,0x55,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x40,0x55,0x55,0x01,0x14,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x50,0x04,0x55,0x45,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x15,0x00,0x40,0x55,0x55,0x55,0x55,0x55},
+    {0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x54,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x54,0x00,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x05,0x44,0x55,0x55,0x55,0x55,0x55,0x45,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x44,0x15,0x04,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x50,0x55,0x10,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x40,0x11,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x51,0x00,0x10,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x05,0x10,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x41,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x44,0x15,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x05,0x55,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x01,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x14,0x40,0x55,0x15,0x55,0x55,0x01,0x40,0x01,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x00,0x40,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x40,0x00,0x10,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x00,0x00,0x00,0x00,0x05,0x00,0x04,0x41,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x40,0x45,0x10,0x00,0x10,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x11,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x54,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x54,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x54,0x55,0x55,0x5A,0x55,0x55,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0xAA,0xAA,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xA9,0xAA,0x69},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x6A,0x55,0x55,0x55,0x55,0xAA,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x41,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x50,0x00,0x00,0x00,0x00,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x50,0x55,0x15,0x00,0x00,0x00,0x40,0x01,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x15,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x54,0x55,0x51,0x55,0x55,0x55,0x54,0x55,0x55,0x55,0x55,0x15,0x00,0x01,0x00,0x00,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x00,0x40,0x00,0x00,0x00,0x00,0x14,0x00,0x10,0x04,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x65,0xA9,0xAA,0x6A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x6A,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0xAA,0xAA,0x56,0x55,0x5A,0x55,0x55,0x55,0xAA,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x56,0x55,0x55,0xA9,0xAA,0x9A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xA6,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0x95,0xAA,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0x56,0x56,0xAA,0xAA},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0xA6,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x96},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x55,0x95,0x6A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x65,0x55,0x55,0x55,0x55,0x55,0x55,0x69,0x55,0x55,0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x56,0x6A,0xA9,0x55,0xA9,0x55,0x55,0x95,0x56,0x55,0xAA,0xAA,0x56},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0x55,0x56,0x55,0x55,0x55},
+    {0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0xAA,0xAA,0x9A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA},
+    {0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x56,0xAA,0x56,0xAA,0x6A,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x56,0xAA,0xAA,0x6A,0x55,0xAA,0x5A,0x55,0x55,0xAA,0xAA,0x5A,0x55,0xAA,0xAA,0x55,0x55,0xAA,0x6A,0x55,0x55},
+    {0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A},
+    {0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55},
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x55,0x55,0x55,0x55},
+};
+
+int ck_glyph_width(unsigned int glyph) { // How many columns a code point takes up on screen (0, 1, or 2)
+    size_t block;
+
+    if(glyph < 0x7F) // ASCII doesn't need the table
+        return glyph >= 0x20;
+
+    if(glyph < 0x40000)
+        block = CK_WIDTH_INDEX[glyph >> 8];
+    else if(glyph >> 9 == 0xE0000 >> 9)
+        block = CK_WIDTH_INDEX[0x400 + (glyph >> 8 & 1)];
+    else
+        return 1;
+
+    return CK_WIDTH_BLOCKS[block][(glyph & 0xFF) >> 2] >> (glyph & 3) * 2 & 3;
+}
+
+unsigned int ck_utf8_decode(const char *text, size_t len, size_t *used) { // Decode the code point at the start of `text' (at most `len' chars), setting `used' to how many chars it took up (malformed sequences decode to U+FFFD, one char at a time)
+    const unsigned char *in = (const unsigned char *)text;
+    unsigned int glyph;
+    size_t need, i;
+
+    *used = 1;
+
+    if(in[0] < 0x80)
+        return in[0];
+
+    if(in[0] < 0xC2 || in[0] > 0xF4) // Continuation char, overlong 2-char sequence, or beyond U+10FFFF
+        return 0xFFFD;
+
+    need = in[0] < 0xE0 ? 1 : in[0] < 0xF0 ? 2 : 3;
+    glyph = in[0] & (0x3F >> need);
+
+    if(need >= len)
+        return 0xFFFD;
+
+    for(i = 1; i <= need; i++) {
+        if((in[i] & 0xC0) != 0x80)
+            return 0xFFFD;
+
+        glyph = glyph << 6 | (in[i] & 0x3F);
+    }
+
+    if((need == 2 && (glyph < 0x800 || (glyph >= 0xD800 && glyph < 0xE000))) || // Overlong, or a UTF-16 surrogate
+       (need == 3 && (glyph < 0x10000 || glyph > 0x10FFFF)))
+        return 0xFFFD;
+
+    *used = need + 1;
+
+    return glyph;
+}
+
+// Text scanning (for skipping the decoder and width table over runs of printable ASCII, which is most text; the same vector macros compare runs of cells for ck_present(); they're SSE2 or AVX2, so other processors, ARM included, use the plain loops):
+
+#if defined(__AVX2__)
+#define CK_SIMD_WIDTH 32
+#define ck_simd_load(text) _mm256_loadu_si256((const __m256i *)(text))
+#define ck_simd_mask(vector) ((unsigned int)_mm256_movemask_epi8(vector)) /* One bit per char, from its top bit */
+#define ck_simd_mask_less(vector, n) ck_simd_mask(_mm256_cmpgt_epi8(_mm256_set1_epi8(n), (vector))) /* Signed, so chars >= 0x80 count as less too */
+#define ck_simd_mask_equal(vector, n) ck_simd_mask(_mm256_cmpeq_epi8((vector), _mm256_set1_epi8(n)))
+#define ck_simd_equal(a, b) ck_simd_mask(_mm256_cmpeq_epi8((a), (b)))
+#define ck_simd_equal_32(a, b) ((unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32((a), (b))))) /* One bit per 32-bit lane */
+#define CK_SIMD_TYPE __m256i
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CK_SIMD_WIDTH 16
+#define ck_simd_load(text) _mm_loadu_si128((const __m128i *)(text))
+#define ck_simd_mask(vector) ((unsigned int)_mm_movemask_epi8(vector))
+#define ck_simd_mask_less(vector, n) ck_simd_mask(_mm_cmplt_epi8((vector), _mm_set1_epi8(n)))
+#define ck_simd_mask_equal(vector, n) ck_simd_mask(_mm_cmpeq_epi8((vector), _mm_set1_epi8(n)))
+#define ck_simd_equal(a, b) ck_simd_mask(_mm_cmpeq_epi8((a), (b)))
+#define ck_simd_equal_32(a, b) ((unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32((a), (b)))))
+#define CK_SIMD_TYPE __m128i
+#endif
+
+#ifdef CK_SIMD_TYPE
+#define CK_SIMD_ALL (0xFFFFFFFFU >> (32 - CK_SIMD_WIDTH)) /* Mask with every char's bit set */
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ck_popcount(mask) __builtin_popcount(mask)
+#define ck_ctz(mask) __builtin_ctz(mask)
+#else
+static int ck_popcount(unsigned int mask) { // Number of set bits
+    int count = 0;
+
+    for(; mask; mask &= mask - 1)
+        count++;
+
+    return count;
+}
+
+static int ck_ctz(unsigned int mask) { // Number of unset bits below the lowest set one (`mask' mustn't be 0)
+    int count = 0;
+
+    for(; !(mask & 1); mask >>= 1)
+        count++;
+
+    return count;
+}
+#endif
+
+#define CK_WORD_ONES 0x0101010101010101ULL /* For testing 8 chars of a string at a time without vector instructions */
+#define ck_word_has_less(word, n) (((word) - CK_WORD_ONES * (n)) & ~(word) & CK_WORD_ONES * 0x80) /* Is any char in `word' less than `n' (each being < 0x80)? */
+
+size_t ck_ascii_span(const char *text, size_t len) { // How many chars at the start of `text' are printable ASCII (and so 1 column each)
+    size_t i = 0;
+
+#ifdef CK_SIMD_TYPE
+    CK_SIMD_TYPE vector;
+    unsigned int stop;
+
+    for(; len - i >= CK_SIMD_WIDTH; i += CK_SIMD_WIDTH) {
+        vector = ck_simd_load(text + i);
+
+        if((stop = ck_simd_mask_less(vector, 0x20) | ck_simd_mask_equal(vector, 0x7F))) // Controls, DEL, or (being signed) non-ASCII
+            return i + ck_ctz(stop);
+    }
+#else
+    unsigned long long word;
+
+    for(; len - i >= 8; i += 8) {
+        memcpy(&word, text + i, 8);
+
+        if(word & CK_WORD_ONES * 0x80 || ck_word_has_less(word, 0x20) || ck_word_has_less(word ^ CK_WORD_ONES * 0x7F, 1))
+            break;
+    }
+#endif
+
+    for(; i < len && (unsigned char)text[i] >= 0x20 && text[i] != 0x7F && (unsigned char)text[i] < 0x80; i++);
+
+    return i;
+}
+
+struct ck_text_scan ck_scan_text(const char *text, size_t len) { // Validate UTF-8 and count control chars, checking runs of ASCII a vector at a time
+    struct ck_text_scan scan = {len, 0, 0, 1};
+    size_t i = 0,
+           used;
+
+    while(i < len) {
+#ifdef CK_SIMD_TYPE
+        CK_SIMD_TYPE vector;
+        unsigned int high, upTo,
+                     controls, escapes;
+
+        if(len - i >= CK_SIMD_WIDTH) {
+            vector = ck_simd_load(text + i);
+
+            high = ck_simd_mask(vector),
+            controls = (ck_simd_mask_less(vector, 0x20) & ~high) | ck_simd_mask_equal(vector, 0x7F),
+            escapes = ck_simd_mask_equal(vector, 0x1B);
+
+            // Count up to the first non-ASCII char, which needs decoding to be validated:
+
+            upTo = high ? ck_ctz(high) : CK_SIMD_WIDTH;
+
+            if(upTo < 32)
+                controls &= (1u << upTo) - 1,
+                escapes &= (1u << upTo) - 1;
+
+            scan.controls += ck_popcount(controls),
+            scan.escapes += ck_popcount(escapes);
+
+            if((i += upTo) == len || !high)
+                continue;
+        }
+#else
+        unsigned long long word;
+
+        if(len - i >= 8) { // Words of printable ASCII have nothing to count
+            memcpy(&word, text + i, 8);
+
+            if(!(word & CK_WORD_ONES * 0x80 || ck_word_has_less(word, 0x20) || ck_word_has_less(word ^ CK_WORD_ONES * 0x7F, 1))) {
+                i += 8;
+                continue;
+            }
+        }
+#endif
+
+        if((unsigned char)text[i] < 0x80) {
+            scan.controls += (unsigned char)text[i] < 0x20 || text[i] == 0x7F,
+            scan.escapes += text[i++] == 0x1B;
+
+            continue;
+        }
+
+        if(scan.ascii == len)
+            scan.ascii = i;
+
+        if(ck_utf8_decode(text + i, len - i, &used) == 0xFFFD && used == 1) // A real U+FFFD takes 3 chars
+            scan.valid = 0;
+
+        i += used;
+    }
+
+    return scan;
+}
+
+size_t ck_utf8_width(const char *text, size_t len) { // How many columns `len' chars of UTF-8 take up on screen
+    size_t width = 0,
+           span,
+           used,
+           i = 0;
+
+    while(i < len) {
+        span = ck_ascii_span(text + i, len - i);
+
+        width += span,
+        i += span;
+
+        if(i < len)
+            width += ck_glyph_width(ck_utf8_decode(text + i, len - i, &used)),
+            i += used;
+    }
+
+    return width;
+}
+
+size_t ck_grid_match(const struct ck_grid *a, size_t aIndex, const struct ck_grid *b, size_t bIndex, size_t count) { // How many of the `count' cells from `aIndex' of `a' match those from `bIndex' of `b' before the first that doesn't (comparing a vector's worth at a time)
+    size_t matched = 0;
+
+#ifdef CK_SIMD_TYPE
+    unsigned int same,
+                 lanes;
+    size_t i;
+
+    // The attributes of CK_SIMD_WIDTH cells fit in a vector, and the other fields in 4 each:
+
+    for(; matched + CK_SIMD_WIDTH <= count; matched += CK_SIMD_WIDTH) {
+        same = ck_simd_equal(ck_simd_load(a->attr + aIndex + matched), ck_simd_load(b->attr + bIndex + matched));
+
+        for(lanes = 0, i = 0; i < CK_SIMD_WIDTH; i += CK_SIMD_WIDTH / 4)
+            lanes |= (ck_simd_equal_32(ck_simd_load(a->glyph + aIndex + matched + i), ck_simd_load(b->glyph + bIndex + matched + i)) &
+                      ck_simd_equal_32(ck_simd_load(a->fg + aIndex + matched + i), ck_simd_load(b->fg + bIndex + matched + i)) &
+                      ck_simd_equal_32(ck_simd_load(a->bg + aIndex + matched + i), ck_simd_load(b->bg + bIndex + matched + i))) << i;
+
+        if((same &= lanes) != CK_SIMD_ALL)
+            return matched + ck_ctz(~same);
+    }
+#endif
+
+    for(; matched < count && ck_grid_cells_equal(a, aIndex + matched, b, bIndex + matched); matched++);
+
+    return matched;
+}
+
+#define ck_hash_cell(hash, grid, index) /* Mix a cell into a running hash */ \
+    ((hash) = ((hash) ^ ((unsigned long long)(grid)->fg[index] << 32 | (grid)->glyph[index])) * 0x9E3779B97F4A7C15ULL, \
+     (hash) = ((hash) ^ ((unsigned long long)(grid)->attr[index] << 32 | (grid)->bg[index])) * 0xC2B2AE3D27D4EB4FULL, \
+     (hash) ^= (hash) >> 29)
+
+unsigned long long ck_grid_hash_row(struct ck_grid *grid, size_t y) { // Hash of row `y' (never 0), only worked out again if the row has been written to since last time
+    unsigned long long a = 1, b = 2, c = 3, d = 4; // Every 4th cell goes into the same one of these, so their multiplies can overlap
+    size_t index = ck_grid_index(grid, 0, y),
+           end = index + grid->width;
+
+    if(grid->hashes[y])
+        return grid->hashes[y];
+
+    for(; index + 4 <= end; index += 4)
+        ck_hash_cell(a, grid, index),
+        ck_hash_cell(b, grid, index + 1),
+        ck_hash_cell(c, grid, index + 2),
+        ck_hash_cell(d, grid, index + 3);
+
+    for(; index < end; index++)
+        ck_hash_cell(a, grid, index);
+
+    a = (a ^ b * 0x94D049BB133111EBULL ^ c * 0xBF58476D1CE4E5B9ULL ^ d * 0xD6E8FEB86659FD93ULL ^ grid->width) * 0x9E3779B97F4A7C15ULL;
+    a ^= a >> 32;
+
+    return grid->hashes[y] = a ? a : 1;
+}
+
+static size_t ck_sgr_colour(char *out, unsigned char base, unsigned int colour) { // Write the SGR parameters for `colour' (base 30 for foreground, 40 for background) to `out', returning their length
+    if(colour & CK_COLOUR_DEFAULT)
+        return sprintf(out, ";%d", base + 9);
+
+    if(colour & CK_COLOUR_PALETTE)
+        return sprintf(out, ";%d;5;%u", base + 8, colour & 0xFF);
+
+    return sprintf(out, ";%d;2;%u;%u;%u", base + 8, colour >> 16 & 0xFF, colour >> 8 & 0xFF, colour & 0xFF);
+}
+
+size_t ck_sgr(char *out, struct ck_sgr_state *state, const struct ck_cell *cell) { // Write the shortest SGR sequence (at most 50 chars) that takes the terminal from `state' to `cell''s formatting, and update `state'
+    static const unsigned char attrCodes[] = {1, 2, 3, 4, 5, 7}; // In the order of the CK_ATTR_* bits
+
+    size_t len = 2,
+           i;
+
+    if(state->known && state->fg == cell->fg && state->bg == cell->bg && state->attr == cell->attr)
+        return 0;
+
+    out[0] = '\033', out[1] = '[';
+
+    // Attributes can only be switched off all at once, so start from scratch if any need to go:
+
+    if(!state->known || state->attr & ~cell->attr) {
+        out[len++] = '0';
+
+        state->fg = state->bg = CK_COLOUR_DEFAULT,
+        state->attr = 0,
+        state->known = 1;
+    }
+
+    for(i = 0; i < sizeof(attrCodes); i++)
+        if(cell->attr & ~state->attr & 1 << i)
+            len += sprintf(out + len, ";%d", attrCodes[i]);
+
+    if(cell->fg != state->fg)
+        len += ck_sgr_colour(out + len, 30, cell->fg);
+
+    if(cell->bg != state->bg)
+        len += ck_sgr_colour(out + len, 40, cell->bg);
+
+    out[len++] = 'm';
+
+    if(out[2] == ';') // Nothing was reset, so the first parameter has a stray separator
+        memmove(out + 2, out + 3, --len - 2);
+
+    state->fg = cell->fg,
+    state->bg = cell->bg,
+    state->attr = cell->attr;
+
+    return len;
+}
+
+void ck_write_cells(const struct ck_grid *grid, size_t index, size_t count, _Bool toEdge, struct ck_sgr_state *state, struct ck_segment *segment) { // Write `count' cells from `index' of the grid to `segment' (or the CK_SCREEN_BUFFER if it's NULL) at the current cursor position, only changing formatting where needed (`toEdge' says the run ends at the right of the screen; the cursor is left somewhere on the row)
+    struct ck_cell cell;
+    char out[256];
+    size_t len = 0,
+           run,
+           glyphLen,
+           seqLen;
+
+    for(; count; index += run, count -= run) {
+        if(len > sizeof(out) - 100) // Room for the longest SGR sequence plus the longest erase sequence
+            ck_segment_write(segment, out, len),
+            len = 0;
+
+        if(grid->glyph[index] == CK_WIDE_CONTINUATION) { // Already covered by the glyph before it
+            run = 1;
+            continue;
+        }
+
+        run = count > 1 && ck_grid_cells_equal(grid, index, grid, index + 1) ? 2 + ck_grid_match(grid, index + 1, grid, index + 2, count - 2) : 1, // Each cell matching the one after it (checking one first, since most runs are short)
+        cell = ck_grid_get(grid, index);
+
+        len += ck_sgr(out + len, state, &cell);
+
+        // Blanks in the default colours can be erased rather than written (erasing uses the current background, but not every terminal agrees on whether it should, hence only the default):
+
+        if(cell.glyph == ' ' && cell.bg == CK_COLOUR_DEFAULT && !(cell.attr & (CK_ATTR_UNDERLINE | CK_ATTR_REVERSE))) {
+            if(toEdge && run == count && run > 3) {
+                memcpy(out + len, "\033[K", 3);
+                len += 3;
+                continue;
+            }
+
+            if(run > 8 && (seqLen = sprintf(out + len, run == count ? "\033[%zuX" : "\033[%zuX\033[%zuC", run, run)) < run) {
+                len += seqLen;
+                continue;
+            }
+        }
+
+        // Anything else can be written once and then repeated:
+
+        len += glyphLen = ck_utf8_encode(cell.glyph, out + len);
+
+        if(run > 1 && CK_CAPABILITIES & CK_CAP_REP && (run - 1) * glyphLen > 6)
+            len += sprintf(out + len, "\033[%zub", run - 1);
+        else
+            for(seqLen = 1; seqLen < run; seqLen++) {
+                if(len > sizeof(out) - 4)
+                    ck_segment_write(segment, out, len),
+                    len = 0;
+
+                len += ck_utf8_encode(cell.glyph, out + len);
+            }
+    }
+
+    ck_segment_write(segment, out, len);
+}
+
+void ck_grid_resize(struct ck_grid *grid, size_t width, size_t height) { // (Re)allocate a grid, keeping whatever content still fits and blanking the rest
+    struct ck_grid old = *grid;
+    size_t cells = width && height ? width * height : 1,
+           i;
+
+    // Allocate memory for each of the arrays:
+
+    if((grid->glyph = (unsigned int *)calloc(cells, sizeof(unsigned int))) == NULL ||
+       (grid->fg = (unsigned int *)calloc(cells, sizeof(unsigned int))) == NULL ||
+       (grid->bg = (unsigned int *)calloc(cells, sizeof(unsigned int))) == NULL ||
+       (grid->attr = (unsigned char *)calloc(cells, sizeof(unsigned char))) == NULL ||
+       (grid->hashes = (unsigned long long *)calloc(height ? height : 1, sizeof(unsigned long long))) == NULL) {
+        perror("Error allocating memory for ck_grid: ");
+        exit(EXIT_FAILURE);
+    }
+
+    grid->width = width,
+    grid->height = height;
+
+    for(i = 0; i < cells; i++)
+        ck_grid_store(grid, i, CK_BLANK_CELL);
+
+    for(i = 0; i < height && i < old.height; i++) {
+        ck_grid_copy(grid, ck_grid_index(grid, 0, i), &old, ck_grid_index(&old, 0, i), width < old.width ? width : old.width);
+
+        if(width && width < old.width && old.glyph[ck_grid_index(&old, width, i)] == CK_WIDE_CONTINUATION) // A double-width glyph cut in half (no room for its right half, as in ck_grid_put())
+            grid->glyph[ck_grid_index(grid, width - 1, i)] = ' ';
+    }
+
+    ck_grid_free(&old);
+}
+
+static void ck_grid_split_wide(struct ck_grid *grid, size_t x, size_t y) { // Blank whichever half of a double-width glyph is left behind when the cell at (x, y) is overwritten
+    size_t index = ck_grid_index(grid, x, y);
+
+    if(grid->glyph[index] == CK_WIDE_CONTINUATION && x > 0)
+        grid->glyph[index - 1] = ' ';
+    else if(x + 1 < grid->width && grid->glyph[index + 1] == CK_WIDE_CONTINUATION)
+        grid->glyph[index + 1] = ' ';
+}
+
+void ck_grid_put(struct ck_grid *grid, size_t x, size_t y, struct ck_cell cell) { // Set a single cell, and the one to its right if the glyph is double-width (ignored if off the grid)
+    if(x >= grid->width || y >= grid->height)
+        return;
+
+    ck_grid_touch(grid, y);
+    ck_grid_split_wide(grid, x, y);
+
+    if(ck_glyph_width(cell.glyph) == 2) {
+        if(x + 1 == grid->width) // No room for the right half
+            cell.glyph = ' ';
+        else {
+            ck_grid_split_wide(grid, x + 1, y);
+
+            ck_grid_store(grid, ck_grid_index(grid, x + 1, y), cell);
+            grid->glyph[ck_grid_index(grid, x + 1, y)] = CK_WIDE_CONTINUATION;
+        }
+    }
+
+    ck_grid_store(grid, ck_grid_index(grid, x, y), cell);
+}
+
+void ck_grid_fill(struct ck_grid *grid, size_t x, size_t y, size_t width, size_t height, struct ck_cell cell) { // Set every cell in a rectangle (clipped to the grid) to a single-width glyph
+    size_t i, j,
+           index;
+
+    if(x >= grid->width || y >= grid->height || !width)
+        return;
+
+    if(width > grid->width - x)
+        width = grid->width - x;
+
+    if(height > grid->height - y)
+        height = grid->height - y;
+
+    for(j = y; j < y + height; j++) {
+        ck_grid_touch(grid, j);
+        ck_grid_split_wide(grid, x, j);
+        ck_grid_split_wide(grid, x + width - 1, j);
+
+        for(index = ck_grid_index(grid, x, j), i = 0; i < width; i++)
+            ck_grid_store(grid, index + i, cell);
+    }
+}
+
+size_t ck_grid_text(struct ck_grid *grid, size_t x, size_t y, const char *text, unsigned int fg, unsigned int bg, unsigned char attr) { // Write a UTF-8 string into a row of the grid, returning how many columns were written (stops at the edge; cells hold one code point, so combining marks are dropped)
+    struct ck_cell cell = {0, fg, bg, attr};
+    size_t written = 0,
+           len = strlen(text),
+           used,
+           span,
+           index,
+           i;
+
+    if(x >= grid->width || y >= grid->height)
+        return 0;
+
+    ck_grid_touch(grid, y);
+
+    while(len && x + written < grid->width) {
+        // Printable ASCII is one cell per char, so whole runs of it can skip decoding and the width table:
+
+        if((span = ck_ascii_span(text, len))) {
+            if(span > grid->width - x - written)
+                span = grid->width - x - written;
+
+            ck_grid_split_wide(grid, x + written, y);
+            ck_grid_split_wide(grid, x + written + span - 1, y);
+
+            for(index = ck_grid_index(grid, x + written, y), i = 0; i < span; i++)
+                cell.glyph = (unsigned char)text[i],
+                ck_grid_store(grid, index + i, cell);
+
+            text += span, len -= span,
+            written += span;
+
+            continue;
+        }
+        if((unsigned char)*text < 0x80) { // Control char
+            text++, len--;
+            continue;
+        }
+
+        cell.glyph = ck_utf8_decode(text, len, &used);
+        text += used, len -= used;
+
+        switch(ck_glyph_width(cell.glyph)) {
+            case 2:
+                if(x + written + 1 == grid->width) { // Doesn't fit, so leave a blank instead of half a glyph (as a terminal would)
+                    cell.glyph = ' ';
+                    ck_grid_put(grid, x + written, y, cell);
+
+                    return written + 1;
+                }
+
+                ck_grid_put(grid, x + written, y, cell);
+                written += 2;
+
+                break;
+
+            case 1:
+                ck_grid_put(grid, x + written++, y, cell);
+        }
+    }
+
+    return written;
+}
+
+void ck_grid_scroll(struct ck_grid *grid, size_t y, size_t height, long amount) { // Move rows `y' to `y + height - 1' of the grid upward by `amount' rows (downward if negative), blanking the ones left behind
+    size_t shift = amount < 0 ? -amount : amount;
+
+    if(y >= grid->height || !amount)
+        return;
+
+    if(height > grid->height - y)
+        height = grid->height - y;
+
+    if(shift > height)
+        shift = height;
+
+    if(amount > 0)
+        ck_grid_copy(grid, ck_grid_index(grid, 0, y), grid, ck_grid_index(grid, 0, y + shift), (height - shift) * grid->width),
+        memmove(grid->hashes + y, grid->hashes + y + shift, (height - shift) * sizeof(unsigned long long)),
+        ck_grid_fill(grid, 0, y + height - shift, grid->width, shift, CK_BLANK_CELL);
+    else
+        ck_grid_copy(grid, ck_grid_index(grid, 0, y + shift), grid, ck_grid_index(grid, 0, y), (height - shift) * grid->width),
+        memmove(grid->hashes + y + shift, grid->hashes + y, (height - shift) * sizeof(unsigned long long)),
+        ck_grid_fill(grid, 0, y, grid->width, shift, CK_BLANK_CELL);
+}
+
+void ck_damage(size_t x, size_t y, size_t width, size_t height) { // Mark a rectangle of CK_GRID as needing to be written on the next ck_flip()
+    struct ck_rect rect = {x, y, width, height},
+                   *existing;
+    size_t i;
+
+    // Clip to CK_GRID:
+
+    if(x >= CK_GRID.width || y >= CK_GRID.height || !width || !height)
+        return;
+
+    if(rect.width > CK_GRID.width - x)
+        rect.width = CK_GRID.width - x;
+
+    if(rect.height > CK_GRID.height - y)
+        rect.height = CK_GRID.height - y;
+
+    // Don't bother if an existing rectangle covers it already, and absorb any that it covers:
+
+    for(i = 0; i < CK_DAMAGE_BUFFER_END; i++) {
+        existing = &CK_DAMAGE_BUFFER[i];
+
+        if(existing->x <= rect.x && existing->y <= rect.y &&
+           existing->x + existing->width >= rect.x + rect.width && existing->y + existing->height >= rect.y + rect.height)
+            return;
+
+        if(rect.x <= existing->x && rect.y <= existing->y &&
+           rect.x + rect.width >= existing->x + existing->width && rect.y + rect.height >= existing->y + existing->height)
+            *existing = CK_DAMAGE_BUFFER[--CK_DAMAGE_BUFFER_END], i--;
+    }
+
+    // Automatic reallocation if needed:
+
+    if(CK_DAMAGE_BUFFER_END == CK_DAMAGE_BUFFER_SIZE) {
+        CK_DAMAGE_BUFFER_SIZE = CK_DAMAGE_BUFFER_SIZE ? 2 * CK_DAMAGE_BUFFER_SIZE : 16;
+
+        if((CK_ALLOC_BUFFER = (void *)realloc(CK_DAMAGE_BUFFER, CK_DAMAGE_BUFFER_SIZE * sizeof(struct ck_rect))) == NULL) {
+            perror("Error reallocating memory for CK_DAMAGE_BUFFER: ");
+            exit(EXIT_FAILURE);
+        }
+
+        CK_DAMAGE_BUFFER = (struct ck_rect *)CK_ALLOC_BUFFER;
+    }
+
+    CK_DAMAGE_BUFFER[CK_DAMAGE_BUFFER_END++] = rect;
+}
+
+#define ck_damage_all() ck_damage(0, 0, CK_GRID.width, CK_GRID.height) /* Mark the whole of CK_GRID as needing to be written */
+
+void ck_latency_mark(const struct ck_event *event) { // Count the next ck_flip() as showing the result of handling `event' (done for you by ck_run() and ck_poll_event())
+    if(!CK_LATENCY_PENDING || event->time < CK_LATENCY_PENDING)
+        CK_LATENCY_PENDING = event->time;
+}
+
+static int ck_latency_compare(const void *a, const void *b) { // For qsort()ing latencies
+    return *(const unsigned long long *)a < *(const unsigned long long *)b ? -1 : *(const unsigned long long *)a > *(const unsigned long long *)b;
+}
+
+struct ck_latency_stats ck_latency_stats(void) { // Percentiles of the latest CK_LATENCY_SAMPLES input latencies
+    static unsigned long long sorted[CK_LATENCY_SAMPLES];
+    struct ck_latency_stats stats = {0, 0, 0, 0, 0};
+
+    if(!(stats.samples = CK_LATENCY_COUNT < CK_LATENCY_SAMPLES ? CK_LATENCY_COUNT : CK_LATENCY_SAMPLES))
+        return stats;
+
+    memcpy(sorted, CK_LATENCY_BUFFER, stats.samples * sizeof(unsigned long long));
+    qsort(sorted, stats.samples, sizeof(unsigned long long), ck_latency_compare);
+
+    stats.p50 = sorted[(stats.samples - 1) * 50 / 100],
+    stats.p90 = sorted[(stats.samples - 1) * 90 / 100],
+    stats.p99 = sorted[(stats.samples - 1) * 99 / 100],
+    stats.max = sorted[stats.samples - 1];
+
+    return stats;
+}
+
+void ck_flip(void) { // Print the contents of CK_SCREEN_BUFFER followed by the damaged regions of CK_GRID (and anything ck_present() put in CK_BAND_BUFFER), and subsequently clear them
+    struct ck_sgr_state state = {0, 0, 0, 0}; // Anything ck_print()ed may have changed the formatting, so don't assume
+    struct ck_rect *rect;
+    size_t i, y,
+           row,
+           left, right;
+
+    // Only the damaged regions get written, each row of which needs a single cursor movement:
+
+    for(rect = CK_DAMAGE_BUFFER; rect < CK_DAMAGE_BUFFER + CK_DAMAGE_BUFFER_END; rect++)
+        for(y = rect->y; y < rect->y + rect->height; y++) {
+            row = ck_grid_index(&CK_GRID, 0, y),
+            left = rect->x,
+            right = rect->x + rect->width;
+
+            // Double-width glyphs have to be written whole:
+
+            if(left && CK_GRID.glyph[row + left] == CK_WIDE_CONTINUATION)
+                left--;
+
+            if(right < CK_GRID.width && CK_GRID.glyph[row + right] == CK_WIDE_CONTINUATION)
+                right++;
+
+            ck_print(ck_cursor_goto(left + 1, y + 1));
+            ck_write_cells(&CK_GRID, row + left, right - left, right == CK_GRID.width, &state, NULL);
+
+            if(CK_GRID_DISPLAYED.width == CK_GRID.width && CK_GRID_DISPLAYED.height == CK_GRID.height) // Keep ck_present() up to date
+                ck_grid_copy(&CK_GRID_DISPLAYED, row + left, &CK_GRID, row + left, right - left),
+                ck_grid_touch(&CK_GRID_DISPLAYED, y);
+        }
+
+    if(state.known)
+        ck_print(CK_RESET_FORMATTING);
+
+    ck_output_frame(CK_BAND_BUFFER, CK_BAND_BUFFER_END);
+
+    // Now it's been written, any input handled since the last flip has had its effect:
+
+    if(CK_LATENCY_PENDING)
+        CK_LATENCY_BUFFER[CK_LATENCY_COUNT++ % CK_LATENCY_SAMPLES] = ck_now() - CK_LATENCY_PENDING,
+        CK_LATENCY_PENDING = 0;
+
+    CK_SCREEN_BUFFER[CK_SCREEN_BUFFER_END = 0] = '\0';
+    CK_DAMAGE_BUFFER_END = 0;
+
+    for(i = 0; i < CK_BAND_BUFFER_END; i++)
+        CK_BAND_BUFFER[i].end = 0;
+
+    CK_BAND_BUFFER_END = 0;
+}
+
+void ck_write_scroll(size_t y, size_t height, long amount) { // Write the sequences for scrolling rows `y' to `y + height - 1' (0-based) to the CK_SCREEN_BUFFER
+    ck_print(CK_RESET_FORMATTING); // Lines scrolled in are filled with the current background colour, which should match CK_BLANK_CELL
+    ck_print(ck_scroll_region(y + 1, y + height));
+    ck_print(amount > 0 ? ck_scroll_up(amount) : ck_scroll_down(-amount));
+    ck_print(CK_RESET_SCROLL_REGION);
+}
+
+void ck_scroll(size_t y, size_t height, long amount) { // Scroll rows `y' to `y + height - 1' of CK_GRID upward by `amount' rows (downward if negative), having the terminal move what's already on screen so only the new rows need drawing
+    if(y >= CK_GRID.height || !amount)
+        return;
+
+    if(height > CK_GRID.height - y)
+        height = CK_GRID.height - y;
+
+    ck_grid_scroll(&CK_GRID, y, height, amount);
+
+    if(CK_GRID_DISPLAYED.width == CK_GRID.width && CK_GRID_DISPLAYED.height == CK_GRID.height)
+        ck_grid_scroll(&CK_GRID_DISPLAYED, y, height, amount);
+
+    ck_write_scroll(y, height, amount);
+}
+
+void ck_move_rows(size_t from, size_t to, size_t length) { // Have the terminal move rows `from' to `from + length - 1' (0-based) to start at row `to' by deleting and inserting lines around them, doing the same to CK_GRID_DISPLAYED (rows they pass over are blanked; everything else stays put)
+    size_t height = CK_GRID_DISPLAYED.height,
+           shift;
+
+    ck_print(CK_RESET_FORMATTING); // Inserted lines are filled with the current background colour, which should match CK_BLANK_CELL
+
+    if(to > from) {
+        shift = to - from;
+
+        if(to + length < height) { // Take out the rows it's moving over first, so what's below comes back to where it was when the block is pushed down
+            ck_print(ck_cursor_goto(1, from + length + 1));
+            ck_print(ck_delete_lines(shift));
+            ck_grid_scroll(&CK_GRID_DISPLAYED, from + length, height - from - length, shift);
+        }
+
+        ck_print(ck_cursor_goto(1, from + 1));
+        ck_print(ck_insert_lines(shift));
+        ck_grid_scroll(&CK_GRID_DISPLAYED, from, height - from, -(long)shift);
+    } else {
+        shift = from - to;
+
+        ck_print(ck_cursor_goto(1, to + 1));
+        ck_print(ck_delete_lines(shift));
+        ck_grid_scroll(&CK_GRID_DISPLAYED, to, height - to, shift);
+
+        if(from + length < height) { // Put back what was pulled up from below
+            ck_print(ck_cursor_goto(1, to + length + 1));
+            ck_print(ck_insert_lines(shift));
+            ck_grid_scroll(&CK_GRID_DISPLAYED, to + length, height - to - length, -(long)shift);
+        }
+    }
+}
+
+#ifndef CK_MOVES_MAX
+#define CK_MOVES_MAX 8 /* Most blocks of rows ck_present() has the terminal move each frame */
+#endif
+
+#ifndef CK_MOVE_CANDIDATES
+#define CK_MOVE_CANDIDATES 4 /* How many of the nearest rows on screen with a changed row's content are tried as where it came from (content often repeats, so the nearest isn't always it) */
+#endif
+
+void ck_detect_moves(void) { // Find blocks of rows of CK_GRID_DISPLAYED that have moved vertically in CK_GRID (by matching row hashes), and have the terminal move them into place rather than them being repainted
+    unsigned long long *wanted = CK_GRID.hashes,
+                       *shown = CK_GRID_DISPLAYED.hashes;
+    size_t height = CK_GRID.height,
+           top, bottom,
+           y, next,
+           distance,
+           candidates,
+           from, to, length,
+           first, end,
+           correct,
+           bestFrom = 0, bestTo = 0,
+           bestLength,
+           moves;
+    int side; // 0 to try the row above the changed one, 1 the row below
+
+    for(moves = 0; moves < CK_MOVES_MAX; moves++) {
+        for(y = 0; y < height; y++) // Rows that haven't been written to keep their hashes from last time, so this is usually just a comparison a row
+            ck_grid_hash_row(&CK_GRID, y),
+            ck_grid_hash_row(&CK_GRID_DISPLAYED, y);
+
+        // Only rows between the first and last changed ones can have moved:
+
+        for(top = 0; top < height && wanted[top] == shown[top]; top++);
+
+        if(top == height)
+            return;
+
+        for(bottom = height - 1; wanted[bottom] == shown[bottom]; bottom--);
+
+        // Each changed row might have come from any row of the screen that has its content, and brought the rows around it along:
+
+        for(bestLength = 0, y = top; y <= bottom; y = next) {
+            next = y + 1;
+
+            if(wanted[y] == shown[y])
+                continue;
+
+            for(distance = 1, candidates = 0; candidates < CK_MOVE_CANDIDATES && distance <= bottom - top; distance++)
+                for(side = 0; side < 2; side++) {
+                    if(side ? y + distance > bottom : y < top + distance)
+                        continue;
+
+                    if(shown[from = side ? y + distance : y - distance] != wanted[y])
+                        continue;
+
+                    candidates++;
+
+                    for(to = y; to > top && from > top && wanted[to - 1] == shown[from - 1]; to--, from--);
+                    for(length = y - to + 1; to + length <= bottom && from + length <= bottom && wanted[to + length] == shown[from + length]; length++);
+
+                    // Only worth it if it fixes more rows than it breaks:
+
+                    first = from < to ? from : to,
+                    end = (from > to ? from : to) + length;
+
+                    for(correct = 0; first < end; first++)
+                        correct += wanted[first] == shown[first];
+
+                    if(length > correct && length > bestLength)
+                        bestFrom = from, bestTo = to, bestLength = length;
+
+                    if(to + length > next) // Rows it covers would only find it again
+                        next = to + length;
+                }
+        }
+
+        if(!bestLength)
+            return;
+
+        ck_move_rows(bestFrom, bestTo, bestLength);
+    }
+}
+
+// Thread pool (for splitting work on the grid across processors):
+
+#ifndef CK_POOL_THREADS
+#define CK_POOL_THREADS 0 /* Worker threads to start (0 for one less than the number of processors, since the calling thread works too) */
+#endif
+
+struct ck_pool { // Workers waiting for a batch of jobs from ck_parallel_for()
+    ck_thread *threads;
+    size_t size;
+
+    ck_mutex lock;
+    ck_cond wake, // Broadcast when a batch starts (or the pool is ending)
+            done; // Broadcast when the last worker finishes a batch
+
+    ck_job job;
+    void *data;
+    size_t count,
+           batch, // Counts up with each batch, so workers can tell a new one from a spurious wakeup
+           busy; // Workers still on the current batch
+    atomic_size_t next; // Next job index to be taken (whoever's free takes the next one, so uneven jobs balance out)
+    _Bool ending;
+};
+
+struct ck_pool CK_POOL;
+
+static void ck_pool_work(void) { // Take jobs from the current batch until there are none left
+    size_t index;
+
+    while((index = atomic_fetch_add_explicit(&CK_POOL.next, 1, memory_order_relaxed)) < CK_POOL.count)
+        CK_POOL.job(index, CK_POOL.data);
+}
+
+static void *ck_pool_worker(void *unused) { // What each of the pool's threads runs
+    size_t batch = 0; // Every batch since the pool started is its business (ck_pool_end() sets CK_POOL.batch back to 0), even one that began before it first got the lock
+
+    (void)unused;
+
+    ck_mutex_lock(&CK_POOL.lock);
+
+    for(;;) {
+        while(CK_POOL.batch == batch && !CK_POOL.ending)
+            ck_cond_wait(&CK_POOL.wake, &CK_POOL.lock);
+
+        if(CK_POOL.ending)
+            break;
+
+        batch = CK_POOL.batch;
+
+        ck_mutex_unlock(&CK_POOL.lock);
+        ck_pool_work();
+        ck_mutex_lock(&CK_POOL.lock);
+
+        if(!--CK_POOL.busy)
+            ck_cond_broadcast(&CK_POOL.done);
+    }
+
+    ck_mutex_unlock(&CK_POOL.lock);
+
+    return NULL;
+}
+
+void ck_pool_start(void) { // Start the pool's threads (ck_parallel_for() does this itself the first time)
+    size_t i;
+
+    CK_POOL.size = CK_POOL_THREADS ? CK_POOL_THREADS : ck_cpu_count() - 1;
+
+    if((CK_POOL.threads = (ck_thread *)calloc(CK_POOL.size ? CK_POOL.size : 1, sizeof(ck_thread))) == NULL) {
+        perror("Error allocating memory for CK_POOL: ");
+        exit(EXIT_FAILURE);
+    }
+
+    ck_mutex_init(&CK_POOL.lock);
+    ck_cond_init(&CK_POOL.wake);
+    ck_cond_init(&CK_POOL.done);
+
+    for(i = 0; i < CK_POOL.size; i++)
+        CK_POOL.threads[i] = ck_thread_start(ck_pool_worker, NULL);
+}
+
+void ck_pool_end(void) { // Stop the pool's threads
+    size_t i;
+
+    if(!CK_POOL.threads)
+        return;
+
+    ck_mutex_lock(&CK_POOL.lock);
+    CK_POOL.ending = 1;
+    ck_cond_broadcast(&CK_POOL.wake);
+    ck_mutex_unlock(&CK_POOL.lock);
+
+    for(i = 0; i < CK_POOL.size; i++)
+        ck_thread_join(CK_POOL.threads[i]);
+
+    free(CK_POOL.threads);
+
+    CK_POOL.threads = NULL,
+    CK_POOL.batch = CK_POOL.busy = 0,
+    CK_POOL.ending = 0;
+}
+
+void ck_parallel_for(size_t count, ck_job job, void *data) { // Call `job(i, data)' for every `i' below `count', spread across the pool (and the calling thread), returning once they're all done
+    size_t i;
+
+    if(!CK_POOL.threads)
+        ck_pool_start();
+
+    if(!CK_POOL.size || count < 2) { // Not worth waking anyone
+        for(i = 0; i < count; i++)
+            job(i, data);
+
+        return;
+    }
+
+    ck_mutex_lock(&CK_POOL.lock);
+
+    CK_POOL.job = job,
+    CK_POOL.data = data,
+    CK_POOL.count = count,
+    CK_POOL.busy = CK_POOL.size,
+    CK_POOL.batch++;
+    atomic_store(&CK_POOL.next, 0);
+
+    ck_cond_broadcast(&CK_POOL.wake);
+    ck_mutex_unlock(&CK_POOL.lock);
+
+    ck_pool_work();
+
+    ck_mutex_lock(&CK_POOL.lock);
+
+    while(CK_POOL.busy)
+        ck_cond_wait(&CK_POOL.done, &CK_POOL.lock);
+
+    ck_mutex_unlock(&CK_POOL.lock);
+}
+
+#ifndef CK_DIFF_GAP
+#define CK_DIFF_GAP 6 /* Unchanged cells between two changes that are cheaper to rewrite than to move the cursor over */
+#endif
+
+#ifndef CK_BAND_CELLS
+#define CK_BAND_CELLS 16384 /* Fewest cells worth diffing on a thread of their own (smaller grids are diffed without involving the pool) */
+#endif
+
+static void ck_present_band(size_t index, void *bandHeight) { // ck_parallel_for() job for diffing one band of rows into its segment of CK_BAND_BUFFER
+    struct ck_segment *segment = &CK_BAND_BUFFER[index];
+    struct ck_sgr_state state = {0, 0, 0, 0}; // Every band starts from scratch, so none depends on how the one before it left things
+    char move[48]; // Not ck_cursor_goto(), since CK_SEQUENCE_BUFFER is shared
+    size_t width = CK_GRID.width,
+           x, y,
+           end,
+           row,
+           start, last;
+
+    y = index * *(size_t *)bandHeight,
+    end = y + *(size_t *)bandHeight < CK_GRID.height ? y + *(size_t *)bandHeight : CK_GRID.height;
+
+    for(; y < end; y++) {
+        // Rows that hash the same as what's on screen haven't changed (and ones that haven't been written to since they were last hashed don't need hashing again):
+
+        if(ck_grid_hash_row(&CK_GRID, y) == ck_grid_hash_row(&CK_GRID_DISPLAYED, y))
+            continue;
+
+        row = ck_grid_index(&CK_GRID, 0, y);
+
+        for(x = ck_grid_match(&CK_GRID, row, &CK_GRID_DISPLAYED, row, width); x < width;) {
+            // Extend the run of changes for as long as the gaps between them are small (the first change past it is where the next run starts):
+
+            for(start = last = x; (x = last + 1 + ck_grid_match(&CK_GRID, row + last + 1, &CK_GRID_DISPLAYED, row + last + 1, width - last - 1)) < width && x - last <= CK_DIFF_GAP; last = x);
+
+            // Double-width glyphs have to be written whole:
+
+            if(start && CK_GRID.glyph[row + start] == CK_WIDE_CONTINUATION)
+                start--;
+
+            if(last + 1 < width && CK_GRID.glyph[row + last + 1] == CK_WIDE_CONTINUATION)
+                last++;
+
+            ck_segment_write(segment, move, sprintf(move, "\033[%zu;%zuH", y + 1, start + 1));
+            ck_write_cells(&CK_GRID, row + start, last - start + 1, last + 1 == width, &state, segment);
+            ck_grid_copy(&CK_GRID_DISPLAYED, row + start, &CK_GRID, row + start, last - start + 1);
+        }
+
+        CK_GRID_DISPLAYED.hashes[y] = CK_GRID.hashes[y]; // They're the same now
+    }
+
+    if(state.known)
+        ck_segment_write(segment, CK_RESET_FORMATTING, sizeof(CK_RESET_FORMATTING) - 1);
+}
+
+static void ck_hash_band(size_t index, void *bandHeight) { // ck_parallel_for() job for hashing one band of rows of both grids, ready for ck_detect_moves()
+    size_t y = index * *(size_t *)bandHeight;
+
+    for(; y < (index + 1) * *(size_t *)bandHeight && y < CK_GRID.height; y++)
+        ck_grid_hash_row(&CK_GRID, y),
+        ck_grid_hash_row(&CK_GRID_DISPLAYED, y);
+}
+
+void ck_present(void) { // Write only the cells of CK_GRID that differ from what's on screen (moving rows that have just moved), then ck_flip()
+    size_t bands,
+           bandHeight;
+    _Bool resized = CK_GRID_DISPLAYED.width != CK_GRID.width || CK_GRID_DISPLAYED.height != CK_GRID.height;
+
+    // Nothing can be assumed about the screen if the size has changed:
+
+    if(resized)
+        ck_grid_resize(&CK_GRID_DISPLAYED, CK_GRID.width, CK_GRID.height),
+        ck_grid_fill(&CK_GRID_DISPLAYED, 0, 0, CK_GRID.width, CK_GRID.height, CK_UNKNOWN_CELL);
+
+    if(!CK_GRID.height) {
+        ck_flip();
+        return;
+    }
+
+    // Big grids are split into bands of rows, each diffed and encoded into its own segment by whichever thread is free (a few per thread, so a band full of changes doesn't hold everyone up):
+
+    if((bands = CK_GRID.width * CK_GRID.height / CK_BAND_CELLS) > 1) {
+        if(!CK_POOL.threads)
+            ck_pool_start();
+
+        if(bands > 4 * (CK_POOL.size + 1))
+            bands = 4 * (CK_POOL.size + 1);
+
+        if(!CK_POOL.size)
+            bands = 1;
+    }
+
+    if(!bands)
+        bands = 1;
+
+    bandHeight = (CK_GRID.height + bands - 1) / bands,
+    bands = (CK_GRID.height + bandHeight - 1) / bandHeight; // Rounding up the height can leave fewer bands needed
+
+    // Automatic reallocation if needed:
+
+    if(bands > CK_BAND_BUFFER_SIZE) {
+        if((CK_ALLOC_BUFFER = (void *)realloc(CK_BAND_BUFFER, bands * sizeof(struct ck_segment))) == NULL) {
+            perror("Error reallocating memory for CK_BAND_BUFFER: ");
+            exit(EXIT_FAILURE);
+        }
+
+        CK_BAND_BUFFER = (struct ck_segment *)CK_ALLOC_BUFFER;
+        memset(CK_BAND_BUFFER + CK_BAND_BUFFER_SIZE, 0, (bands - CK_BAND_BUFFER_SIZE) * sizeof(struct ck_segment));
+        CK_BAND_BUFFER_SIZE = bands;
+    }
+
+    CK_BAND_BUFFER_END = bands;
+
+    if(!resized) { // Rows written to since the last frame get hashed in parallel too, rather than one by one while looking for moves
+        if(bands > 1)
+            ck_parallel_for(bands, ck_hash_band, &bandHeight);
+
+        ck_detect_moves();
+    }
+
+    if(bands == 1)
+        ck_present_band(0, &bandHeight);
+    else
+        ck_parallel_for(bands, ck_present_band, &bandHeight);
+
+    ck_flip();
+}
+
+// Tiles (for drawing independent parts of the screen in parallel):
+
+void ck_tile_init(struct ck_tile *tile, size_t x, size_t y, size_t width, size_t height, ck_tile_callback draw, void *data) { // Set up a tile covering a rectangle of CK_GRID
+    tile->rect = (struct ck_rect){x, y, width, height},
+    tile->grid = (struct ck_grid){NULL, NULL, NULL, NULL, NULL, 0, 0},
+    tile->draw = draw,
+    tile->data = data;
+
+    ck_grid_resize(&tile->grid, width, height);
+}
+
+void ck_tile_free(struct ck_tile *tile) { // Free a tile's cells
+    ck_grid_free(&tile->grid);
+}
+
+void ck_tile_merge(const struct ck_tile *tile) { // Copy a tile's cells into CK_GRID and mark them as damaged (for apps drawing tiles on their own threads)
+    size_t width, y;
+
+    if(tile->rect.x >= CK_GRID.width || tile->rect.y >= CK_GRID.height)
+        return;
+
+    width = tile->rect.width < CK_GRID.width - tile->rect.x ? tile->rect.width : CK_GRID.width - tile->rect.x;
+
+    for(y = 0; y < tile->rect.height && tile->rect.y + y < CK_GRID.height; y++)
+        ck_grid_copy(&CK_GRID, ck_grid_index(&CK_GRID, tile->rect.x, tile->rect.y + y), &tile->grid, ck_grid_index(&tile->grid, 0, y), width),
+        ck_grid_touch(&CK_GRID, tile->rect.y + y);
+
+    ck_damage(tile->rect.x, tile->rect.y, tile->rect.width, tile->rect.height);
+}
+
+static void ck_compose_tile(size_t index, void *tiles) { // ck_parallel_for() job for drawing one tile
+    struct ck_tile *tile = (struct ck_tile *)tiles + index;
+
+    tile->draw(&tile->grid, tile->data);
+}
+
+void ck_compose(struct ck_tile *tiles, size_t count) { // Draw tiles in parallel, then merge them into CK_GRID, ready for ck_flip() (tiles mustn't overlap; cut-off double-width glyphs at their edges are the drawer's business)
+    size_t i;
+
+    ck_parallel_for(count, ck_compose_tile, tiles);
+
+    for(i = 0; i < count; i++)
+        ck_tile_merge(&tiles[i]);
+}
+
+// Sprites (blocks of cells with transparent parts, for games and visualisations to move around the grid rather than drawing each glyph themselves):
+
+void ck_sprite_init(struct ck_sprite *sprite, size_t width, size_t height) { // Set up a sprite that's entirely transparent until drawn into
+    sprite->cells = (struct ck_grid){NULL, NULL, NULL, NULL, NULL, 0, 0};
+
+    ck_grid_resize(&sprite->cells, width, height);
+
+    // Allocate memory for the mask:
+
+    if((sprite->mask = (unsigned char *)calloc(width && height ? width * height : 1, sizeof(unsigned char))) == NULL) {
+        perror("Error allocating memory for ck_sprite: ");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void ck_sprite_free(struct ck_sprite *sprite) { // Free a sprite's cells and mask
+    ck_grid_free(&sprite->cells);
+    free(sprite->mask);
+
+    sprite->mask = NULL;
+}
+
+void ck_sprite_put(struct ck_sprite *sprite, size_t x, size_t y, struct ck_cell cell) { // Set a cell of a sprite and make it opaque (both halves, if the glyph is double-width)
+    if(x >= sprite->cells.width || y >= sprite->cells.height)
+        return;
+
+    ck_grid_put(&sprite->cells, x, y, cell);
+
+    sprite->mask[ck_grid_index(&sprite->cells, x, y)] = 1;
+
+    if(sprite->cells.glyph[ck_grid_index(&sprite->cells, x, y)] != ' ' && ck_glyph_width(cell.glyph) == 2)
+        sprite->mask[ck_grid_index(&sprite->cells, x + 1, y)] = 1;
+}
+
+size_t ck_sprite_text(struct ck_sprite *sprite, size_t x, size_t y, const char *text, unsigned int fg, unsigned int bg, unsigned char attr) { // Write a UTF-8 string into a row of a sprite, making what it covers opaque, and returning how many columns that was
+    size_t written = ck_grid_text(&sprite->cells, x, y, text, fg, bg, attr);
+
+    if(written)
+        memset(sprite->mask + ck_grid_index(&sprite->cells, x, y), 1, written);
+
+    return written;
+}
+
+static size_t ck_mask_run(const unsigned char *mask, size_t len, _Bool opaque) { // How many of the first `len' cells of a sprite's mask are all opaque (or all transparent), checking a vector's worth at a time
+    size_t i = 0;
+
+#ifdef CK_SIMD_TYPE
+    unsigned int ends;
+
+    for(; i + CK_SIMD_WIDTH <= len; i += CK_SIMD_WIDTH)
+        if((ends = ck_simd_mask_equal(ck_simd_load(mask + i), 0) ^ (opaque ? 0 : CK_SIMD_ALL)))
+            return i + ck_ctz(ends);
+#endif
+
+    while(i < len && (mask[i] != 0) == opaque)
+        i++;
+
+    return i;
+}
+
+void ck_blit(struct ck_grid *grid, const struct ck_sprite *sprite, long x, long y) { // Draw the opaque cells of a sprite onto a grid with its top-left at (x, y), clipping whatever falls off the edges (rows are copied a run of opaque cells at a time)
+    const struct ck_grid *cells = &sprite->cells;
+    size_t left = x < 0 ? -x : 0, // Columns and rows of the sprite cut off by the grid's left and top edges
+           top = y < 0 ? -y : 0,
+           width, height,
+           row, gridX, gridY,
+           from, to,
+           start, run;
+
+    if(x >= (long)grid->width || y >= (long)grid->height || left >= cells->width || top >= cells->height)
+        return;
+
+    gridX = x + left,
+    width = cells->width - left < grid->width - gridX ? cells->width - left : grid->width - gridX,
+    height = cells->height - top < grid->height - (y + top) ? cells->height - top : grid->height - (y + top);
+
+    for(row = top; row < top + height; row++) {
+        gridY = y + row,
+        from = ck_grid_index(cells, left, row),
+        to = ck_grid_index(grid, gridX, gridY);
+
+        ck_grid_touch(grid, gridY);
+
+        for(start = 0; (start += ck_mask_run(sprite->mask + from + start, width - start, 0)) < width; start += run) {
+            run = ck_mask_run(sprite->mask + from + start, width - start, 1);
+
+            // Blank whatever halves of double-width glyphs the run cuts through, on the grid and in the sprite (where its edges are transparent or clipped):
+
+            ck_grid_split_wide(grid, gridX + start, gridY);
+            ck_grid_split_wide(grid, gridX + start + run - 1, gridY);
+
+            ck_grid_copy(grid, to + start, cells, from + start, run);
+
+            if(grid->glyph[to + start] == CK_WIDE_CONTINUATION)
+                grid->glyph[to + start] = ' ';
+
+            if(ck_glyph_width(grid->glyph[to + start + run - 1]) == 2)
+                grid->glyph[to + start + run - 1] = ' ';
+        }
+    }
+}
+
+// Pixel canvases (for heatmaps and small images, drawn with `\u2580' so each cell shows two pixels, one in its foreground and one in its background colour):
+
+void ck_canvas_init(struct ck_canvas *canvas, size_t width, size_t height) { // Set up a black canvas of `width' by `height' pixels (rounded up to an even height)
+    canvas->width = width,
+    canvas->height = height + (height & 1);
+
+    // Allocate memory for the pixels, and two rows of errors (for each channel, and a pixel beyond either edge):
+
+    if((canvas->pixels = (unsigned int *)calloc(width && height ? width * canvas->height : 1, sizeof(unsigned int))) == NULL ||
+       (canvas->errors = (int *)calloc(2 * 3 * (width + 2), sizeof(int))) == NULL) {
+        perror("Error allocating memory for ck_canvas: ");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void ck_canvas_free(struct ck_canvas *canvas) { // Free a canvas's pixels
+    free(canvas->pixels);
+    free(canvas->errors);
+
+    canvas->pixels = NULL,
+    canvas->errors = NULL;
+}
+
+static const unsigned char CK_CUBE_VALUES[6] = {0, 95, 135, 175, 215, 255}; // The cube's levels, as xterm (and everything copying it) shows them
+
+#define ck_cube_level(channel) (((channel) >= 48) + ((channel) >= 115) + ((channel) >= 155) + ((channel) >= 195) + ((channel) >= 235)) /* Nearest of the cube's 6 levels to a channel from 0 to 255 (the thresholds being halfway between them) */
+
+unsigned int ck_colour_to_256(unsigned int colour) { // Nearest colour to an RGB value in the 256-colour palette's 6x6x6 cube
+    return ck_colour_256(16 + 36 * ck_cube_level(colour >> 16 & 0xFF) + 6 * ck_cube_level(colour >> 8 & 0xFF) + ck_cube_level(colour & 0xFF));
+}
+
+static const signed char CK_BAYER_OFFSETS[4][4] = { // The 4x4 Bayer matrix, in 32nds of a step of the cube (the step that a threshold's between, so they nudge a channel by up to half of it either way)
+    {-15, 1, -11, 5},
+    {9, -7, 13, -3},
+    {-9, 7, -13, 3},
+    {15, -1, 11, -5}
+};
+
+#if defined(CK_SIMD_TYPE)
+static inline __m128i ck_cube_levels(__m128i channels, __m128i offsets) { // ck_cube_level() of 4 channels (one in each 32-bit lane) nudged by 4 of CK_BAYER_OFFSETS (plus 15, so the 16-bit multiplies never see a negative)
+    __m128i low = _mm_add_epi32(_mm_slli_epi32(channels, 5), _mm_mullo_epi16(offsets, _mm_set1_epi32(95))), // In 32nds, nudged by the first step (0 to 95) and by the rest (40 each)
+            high = _mm_add_epi32(_mm_slli_epi32(channels, 5), _mm_mullo_epi16(offsets, _mm_set1_epi32(40)));
+
+    // Count the thresholds it's reached (compares give -1 for each):
+
+    return _mm_sub_epi32(_mm_setzero_si128(), _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(_mm_cmpgt_epi32(low, _mm_set1_epi32(95 * 16 + 15 * 95 - 1)), _mm_cmpgt_epi32(high, _mm_set1_epi32(115 * 32 + 15 * 40 - 1))),
+                                                                          _mm_add_epi32(_mm_cmpgt_epi32(high, _mm_set1_epi32(155 * 32 + 15 * 40 - 1)), _mm_cmpgt_epi32(high, _mm_set1_epi32(195 * 32 + 15 * 40 - 1)))),
+                                                           _mm_cmpgt_epi32(high, _mm_set1_epi32(235 * 32 + 15 * 40 - 1))));
+}
+#endif
+
+static void ck_quantise_row(unsigned int *out, const unsigned int *pixels, size_t count, const signed char *offsets) { // Convert `count' pixels to the 256-colour palette, nudged by a row of CK_BAYER_OFFSETS first (if it isn't NULL)
+    size_t i = 0;
+    int offset, low, high;
+    unsigned int channel, shift, levels;
+
+#if defined(CK_SIMD_TYPE) // 4 pixels at a time (SSE2 is there whenever AVX2 is, and 4 matches the matrix's width)
+    __m128i nudges = offsets ? _mm_set_epi32(offsets[3] + 15, offsets[2] + 15, offsets[1] + 15, offsets[0] + 15) : _mm_set1_epi32(15),
+            vector, r, g, b;
+
+    for(; i + 4 <= count; i += 4) {
+        vector = _mm_loadu_si128((const __m128i *)(pixels + i));
+
+        // Each channel's level, in each pixel's lane:
+
+        r = ck_cube_levels(_mm_and_si128(_mm_srli_epi32(vector, 16), _mm_set1_epi32(0xFF)), nudges),
+        g = ck_cube_levels(_mm_and_si128(_mm_srli_epi32(vector, 8), _mm_set1_epi32(0xFF)), nudges),
+        b = ck_cube_levels(_mm_and_si128(vector, _mm_set1_epi32(0xFF)), nudges);
+
+        vector = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi16(r, _mm_set1_epi32(36)), _mm_mullo_epi16(g, _mm_set1_epi32(6))), _mm_add_epi32(b, _mm_set1_epi32(16)));
+
+        _mm_storeu_si128((__m128i *)(out + i), _mm_or_si128(vector, _mm_set1_epi32(CK_COLOUR_PALETTE)));
+    }
+#endif
+
+    for(; i < count; i++) {
+        for(offset = offsets ? offsets[i & 3] : 0, levels = 0, shift = 24; shift;) {
+            channel = pixels[i] >> (shift -= 8) & 0xFF,
+            low = (int)channel * 32 + offset * 95, // In 32nds, nudged by the first step and by the rest (a channel can then only land on the levels either side of it)
+            high = (int)channel * 32 + offset * 40;
+
+            levels = levels * 6 + (low >= 95 * 16) + (high >= 115 * 32) + (high >= 155 * 32) + (high >= 195 * 32) + (high >= 235 * 32);
+        }
+
+        out[i] = ck_colour_256(16 + levels);
+    }
+}
+
+static void ck_diffuse_row(unsigned int *out, const unsigned int *pixels, size_t count, int *errors, int *nextErrors) { // Convert `count' pixels to the 256-colour palette, spreading each one's error onto those to come (Floyd-Steinberg), with `errors' from the rows above and `nextErrors' for the row below (3 per pixel, offset by a pixel)
+    size_t i;
+    unsigned int channel, shift, levels, level;
+    int value, error, c;
+
+    memset(nextErrors, 0, 3 * (count + 2) * sizeof(int));
+
+    for(i = 0; i < count; i++) {
+        for(levels = 0, c = 0, shift = 24; shift; c++) {
+            value = (int)(pixels[i] >> (shift -= 8) & 0xFF) + errors[3 * (i + 1) + c] / 16;
+            channel = value < 0 ? 0 : value > 255 ? 255 : value;
+
+            level = ck_cube_level(channel),
+            levels = levels * 6 + level,
+            error = (int)channel - CK_CUBE_VALUES[level]; // (Against what the terminal will actually show)
+
+            // 7/16 right, 3/16 below left, 5/16 below, 1/16 below right:
+
+            errors[3 * (i + 2) + c] += error * 7,
+            nextErrors[3 * i + c] += error * 3,
+            nextErrors[3 * (i + 1) + c] += error * 5,
+            nextErrors[3 * (i + 2) + c] += error;
+        }
+
+        out[i] = ck_colour_256(16 + levels);
+    }
+}
+
+void ck_canvas_draw(struct ck_grid *grid, struct ck_canvas *canvas, size_t x, size_t y, int mode) { // Draw a canvas onto a grid as half blocks with its top-left at cell (x, y), converting its colours as CK_CANVAS_* `mode' says (clipped to the grid; CK_CANVAS_256_DIFFUSED uses the canvas's `errors' rows, so only one thread can be drawing a canvas at a time)
+    size_t width, rows,
+           row, index,
+           i;
+    int *errors = canvas->errors,
+        *nextErrors = canvas->errors + 3 * (canvas->width + 2),
+        *swap;
+
+    if(x >= grid->width || y >= grid->height || !canvas->width)
+        return;
+
+    width = canvas->width < grid->width - x ? canvas->width : grid->width - x,
+    rows = canvas->height / 2 < grid->height - y ? canvas->height / 2 : grid->height - y;
+
+    if(mode == CK_CANVAS_256_DIFFUSED)
+        memset(errors, 0, 3 * (canvas->width + 2) * sizeof(int));
+
+    for(row = 0; row < rows; row++) {
+        index = ck_grid_index(grid, x, y + row);
+
+        ck_grid_touch(grid, y + row);
+        ck_grid_split_wide(grid, x, y + row);
+        ck_grid_split_wide(grid, x + width - 1, y + row);
+
+        // Top pixels go in the foreground, bottom ones in the background:
+
+        switch(mode) {
+            case CK_CANVAS_RGB:
+                for(i = 0; i < width; i++)
+                    grid->fg[index + i] = canvas->pixels[2 * row * canvas->width + i] & 0xFFFFFF,
+                    grid->bg[index + i] = canvas->pixels[(2 * row + 1) * canvas->width + i] & 0xFFFFFF;
+                break;
+
+            case CK_CANVAS_256:
+            case CK_CANVAS_256_ORDERED:
+                ck_quantise_row(grid->fg + index, canvas->pixels + 2 * row * canvas->width, width, mode == CK_CANVAS_256 ? NULL : CK_BAYER_OFFSETS[2 * row & 3]);
+                ck_quantise_row(grid->bg + index, canvas->pixels + (2 * row + 1) * canvas->width, width, mode == CK_CANVAS_256 ? NULL : CK_BAYER_OFFSETS[(2 * row + 1) & 3]);
+                break;
+
+            case CK_CANVAS_256_DIFFUSED:
+                ck_diffuse_row(grid->fg + index, canvas->pixels + 2 * row * canvas->width, width, errors, nextErrors);
+                swap = errors, errors = nextErrors, nextErrors = swap;
+
+                ck_diffuse_row(grid->bg + index, canvas->pixels + (2 * row + 1) * canvas->width, width, errors, nextErrors);
+                swap = errors, errors = nextErrors, nextErrors = swap;
+                break;
+        }
+
+        // A half block where the two pixels differ, and a space where they don't (which can be cleared rather than printed):
+
+        i = 0;
+
+#if defined(CK_SIMD_TYPE)
+        for(; i + 4 <= width; i += 4) {
+            __m128i same = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(grid->fg + index + i)), _mm_loadu_si128((const __m128i *)(grid->bg + index + i)));
+
+            _mm_storeu_si128((__m128i *)(grid->glyph + index + i), _mm_or_si128(_mm_and_si128(same, _mm_set1_epi32(' ')), _mm_andnot_si128(same, _mm_set1_epi32(0x2580))));
+        }
+#endif
+
+        for(; i < width; i++)
+            grid->glyph[index + i] = grid->fg[index + i] == grid->bg[index + i] ? ' ' : 0x2580;
+
+        memset(grid->attr + index, 0, width);
+    }
+}
+
+// Braille canvases (for line charts and scatter plots, at 2x4 dots to a cell):
+
+void ck_braille_init(struct ck_braille *braille, size_t width, size_t height) { // Set up an empty braille canvas of at least `width' by `height' dots
+    braille->width = (width + 1) & ~(size_t)1,
+    braille->height = (height + 3) & ~(size_t)3;
+
+    // Allocate memory for the cells:
+
+    if((braille->cells = (unsigned char *)calloc(braille->width / 2 * (braille->height / 4) + 1, sizeof(unsigned char))) == NULL) {
+        perror("Error allocating memory for ck_braille: ");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void ck_braille_free(struct ck_braille *braille) { // Free a braille canvas's cells
+    free(braille->cells);
+
+    braille->cells = NULL;
+}
+
+void ck_braille_clear(struct ck_braille *braille) { // Clear every dot
+    memset(braille->cells, 0, braille->width / 2 * (braille->height / 4));
+}
+
+void ck_braille_points(struct ck_braille *braille, const float *xs, const float *ys, size_t count) { // Set the dot nearest each of `count' points (skipping any off the canvas)
+    float width = (float)braille->width - 0.5f,
+          height = (float)braille->height - 0.5f;
+    size_t i;
+
+    for(i = 0; i < count; i++)
+        if(xs[i] >= -0.5f && xs[i] < width && ys[i] >= -0.5f && ys[i] < height) { // (False for NaNs too)
+            size_t x = (size_t)(xs[i] + 0.5f),
+                   y = (size_t)(ys[i] + 0.5f);
+
+            ck_braille_set(braille, x, y);
+        }
+}
+
+void ck_braille_line(struct ck_braille *braille, long x0, long y0, long x1, long y1) { // Set the dots along a line between two dots (clipped to the canvas)
+    double edges[4][2], // Liang-Barsky's p and q for each edge of the canvas
+           from = 0, to = 1, t;
+    long long dx = x1 > x0 ? (long long)x1 - x0 : (long long)x0 - x1,
+              dy = y1 > y0 ? (long long)y1 - y0 : (long long)y0 - y1,
+              major = dx >= dy ? dx : dy, minor = dx >= dy ? dy : dx,
+              step, last, skipped, error, twice;
+    long stepX = x1 > x0 ? 1 : -1,
+         stepY = y1 > y0 ? 1 : -1;
+    int i;
+
+    if(!braille->width || !braille->height)
+        return;
+
+    // Work out which part of the line is on the canvas (give or take the half a dot it gets rounded by), so lines running far off it don't get stepped through dot by dot:
+
+    edges[0][0] = -(double)(x1 - x0), edges[0][1] = x0 + 0.5,
+    edges[1][0] = (double)(x1 - x0), edges[1][1] = braille->width - 0.5 - x0,
+    edges[2][0] = -(double)(y1 - y0), edges[2][1] = y0 + 0.5,
+    edges[3][0] = (double)(y1 - y0), edges[3][1] = braille->height - 0.5 - y0;
+
+    for(i = (unsigned long)x0 < braille->width && (unsigned long)y0 < braille->height && (unsigned long)x1 < braille->width && (unsigned long)y1 < braille->height ? 4 : 0; i < 4; i++) { // (Nothing to clip if both ends are on it, which most segments of a polyline are)
+        if(edges[i][0] == 0) {
+            if(edges[i][1] < 0) // Parallel to this edge, and outside it
+                return;
+
+            continue;
+        }
+
+        t = edges[i][1] / edges[i][0];
+
+        if(edges[i][0] < 0) {
+            if(t > from)
+                from = t;
+        } else if(t < to)
+            to = t;
+    }
+
+    if(from > to)
+        return;
+
+    // Each of Bresenham's steps moves one dot along the major axis, and how many of the first `step' also moved along the minor one has a closed form,
+    // so jump straight to (just before) where the line comes onto the canvas with the same error it'd have had, and it plots exactly the same dots as the whole line would:
+
+    step = from > 0 ? (long long)(from * major) - 1 : 0,
+    last = to < 1 ? (long long)(to * major) + 1 : major;
+
+    if(step < 0)
+        step = 0;
+
+    if(last > major)
+        last = major;
+
+    skipped = 2 * step * minor - major > 0 ? (2 * step * minor - major + 2 * major - 1) / (2 * major) : 0;
+
+    if(dx >= dy)
+        x0 += stepX * (long)step,
+        y0 += stepY * (long)skipped,
+        error = dx - dy - step * dy + skipped * dx;
+    else
+        y0 += stepY * (long)step,
+        x0 += stepX * (long)skipped,
+        error = dx - dy + step * dx - skipped * dy;
+
+    for(; step <= last; step++) {
+        if((unsigned long)x0 < braille->width && (unsigned long)y0 < braille->height) // (The steps either side of the canvas are only there in case of rounding)
+            ck_braille_set(braille, x0, y0);
+
+        twice = 2 * error;
+
+        if(twice > -dy)
+            error -= dy,
+            x0 += stepX;
+
+        if(twice < dx)
+            error += dx,
+            y0 += stepY;
+    }
+}
+
+#define ck_braille_coord(n) ((n) < -(1 << 28) ? -(1L << 28) : (n) > (1 << 28) ? 1L << 28 : (long)floor((n) + 0.5)) /* Round a point's co-ordinate to a dot, clamped well clear of overflowing ck_braille_line() */
+
+void ck_braille_polyline(struct ck_braille *braille, const float *xs, const float *ys, size_t count) { // Join `count' points with lines, in order
+    size_t i;
+
+    for(i = 1; i < count; i++)
+        if(xs[i - 1] == xs[i - 1] && ys[i - 1] == ys[i - 1] && xs[i] == xs[i] && ys[i] == ys[i]) // Leave a gap at NaNs (missing data)
+            ck_braille_line(braille, ck_braille_coord(xs[i - 1]), ck_braille_coord(ys[i - 1]), ck_braille_coord(xs[i]), ck_braille_coord(ys[i]));
+}
+
+void ck_braille_draw(struct ck_grid *grid, const struct ck_braille *braille, size_t x, size_t y, unsigned int fg, unsigned int bg) { // Draw a braille canvas onto a grid with its top-left at cell (x, y), in the given colours (clipped to the grid; empty cells become spaces)
+    const unsigned char *cells;
+    size_t width, rows,
+           row, index,
+           i;
+
+    if(x >= grid->width || y >= grid->height || !braille->width)
+        return;
+
+    width = braille->width / 2 < grid->width - x ? braille->width / 2 : grid->width - x,
+    rows = braille->height / 4 < grid->height - y ? braille->height / 4 : grid->height - y;
+
+    for(row = 0; row < rows; row++) {
+        index = ck_grid_index(grid, x, y + row),
+        cells = braille->cells + row * (braille->width / 2);
+
+        ck_grid_touch(grid, y + row);
+        ck_grid_split_wide(grid, x, y + row);
+        ck_grid_split_wide(grid, x + width - 1, y + row);
+
+        // The dots are already in Unicode's order, so each glyph is just U+2800 plus its byte (and a space where there are none, which can be cleared rather than printed):
+
+        i = 0;
+
+#if defined(CK_SIMD_TYPE)
+        for(; i + 16 <= width; i += 16) {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)(cells + i)),
+                    empty = _mm_cmpeq_epi8(bytes, _mm_setzero_si128()),
+                    glyphs = _mm_or_si128(_mm_and_si128(empty, _mm_set1_epi8(' ')), _mm_andnot_si128(empty, bytes)), // Low bytes, with ' ' for empty cells
+                    high = _mm_andnot_si128(empty, _mm_set1_epi8(0x28)), // The 0x28 of 0x28xx, for non-empty ones
+                    low = _mm_unpacklo_epi8(glyphs, high), upper = _mm_unpackhi_epi8(glyphs, high);
+
+            _mm_storeu_si128((__m128i *)(grid->glyph + index + i), _mm_unpacklo_epi16(low, _mm_setzero_si128()));
+            _mm_storeu_si128((__m128i *)(grid->glyph + index + i + 4), _mm_unpackhi_epi16(low, _mm_setzero_si128()));
+            _mm_storeu_si128((__m128i *)(grid->glyph + index + i + 8), _mm_unpacklo_epi16(upper, _mm_setzero_si128()));
+            _mm_storeu_si128((__m128i *)(grid->glyph + index + i + 12), _mm_unpackhi_epi16(upper, _mm_setzero_si128()));
+        }
+#endif
+
+        for(; i < width; i++)
+            grid->glyph[index + i] = cells[i] ? 0x2800 + cells[i] : ' ';
+
+        for(i = 0; i < width; i++)
+            grid->fg[index + i] = fg,
+            grid->bg[index + i] = bg;
+
+        memset(grid->attr + index, 0, width);
+    }
+}
+
+// Searching (a view's file, in the background, so matches can be jumped to and highlighted as they're found):
+
+size_t ck_find(const char *text, size_t len, const char *needle, size_t needleLen) { // Where the first `needle' in `text' starts (or `len' if there isn't one), checking a vector's worth of places at a time for its first and last chars before comparing the rest
+    size_t i = 0;
+    const char *at;
+
+    if(!needleLen)
+        return 0;
+
+    if(needleLen > len)
+        return len;
+
+#ifdef CK_SIMD_TYPE
+    unsigned int candidates;
+
+    for(; len - i >= needleLen - 1 + CK_SIMD_WIDTH; i += CK_SIMD_WIDTH)
+        for(candidates = ck_simd_mask_equal(ck_simd_load(text + i), needle[0]) & ck_simd_mask_equal(ck_simd_load(text + i + needleLen - 1), needle[needleLen - 1]); candidates; candidates &= candidates - 1)
+            if(needleLen < 3 || !memcmp(text + i + ck_ctz(candidates) + 1, needle + 1, needleLen - 2))
+                return i + ck_ctz(candidates);
+#endif
+
+    // The rest (or all of it, without vector instructions) a first char at a time:
+
+    for(; (at = (const char *)memchr(text + i, needle[0], len - needleLen + 1 - i)) != NULL; i++) {
+        i = at - text;
+
+        if(!memcmp(at + 1, needle + 1, needleLen - 1))
+            return i;
+    }
+
+    return len;
+}
+
+#ifndef CK_SEARCH_SLICE
+#define CK_SEARCH_SLICE (1 << 20) /* Chars a search's thread looks through between saying how far it's got */
+#endif
+
+static size_t *ck_search_slot(const struct ck_search *search, size_t i) { // Where match `i' is kept
+    int block = 0;
+
+    for(; i >= (size_t)CK_SEARCH_CHUNK << block; block++)
+        i -= (size_t)CK_SEARCH_CHUNK << block;
+
+    return search->blocks[block] + i;
+}
+
+static void *ck_search_thread(void *arg) { // Find the matches in a search's view's file, carrying on from wherever it had got to
+    struct ck_search *search = (struct ck_search *)arg;
+    const char *data = search->view->data;
+    size_t size = search->view->size,
+           at = atomic_load_explicit(&search->searched, memory_order_relaxed),
+           found = atomic_load_explicit(&search->found, memory_order_relaxed),
+           end, limit, match;
+    int block;
+
+    if(!search->len) // (Nothing to find)
+        at = size;
+    else if(at) // Back up over the end of what was searched before, in case the file's grown since and a match was cut off (but not into the last match found)
+        at -= at < search->len - 1 ? at : search->len - 1,
+        at = found && ck_search_match(search, found - 1) + search->len > at ? ck_search_match(search, found - 1) + search->len : at;
+
+    while(at < size && !atomic_load_explicit(&search->stop, memory_order_relaxed)) {
+        end = size - at > CK_SEARCH_SLICE ? at + CK_SEARCH_SLICE : size,
+        limit = size - end > search->len - 1 ? end + search->len - 1 : size; // Matches starting in this slice can carry on into the next
+
+        for(; at < end && (match = at + ck_find(data + at, limit - at, search->needle, search->len)) < end; at = match + search->len) {
+            // Start a new block when the last is full:
+
+            for(block = 0; found >= ((size_t)CK_SEARCH_CHUNK << (block + 1)) - CK_SEARCH_CHUNK; block++);
+
+            if(search->blocks[block] == NULL && (search->blocks[block] = (size_t *)malloc(((size_t)CK_SEARCH_CHUNK << block) * sizeof(size_t))) == NULL) {
+                perror("Error allocating memory for ck_search matches: ");
+                exit(EXIT_FAILURE);
+            }
+
+            *ck_search_slot(search, found) = match;
+
+            atomic_store_explicit(&search->found, ++found, memory_order_release);
+        }
+
+        if(at < end)
+            at = end;
+
+        atomic_store_explicit(&search->searched, at, memory_order_release);
+    }
+
+    return NULL;
+}
+
+static void ck_search_pause(struct ck_search *search) { // Stop a search's thread (while its view's file is remapped, say)
+    atomic_store(&search->stop, 1);
+    ck_thread_join(search->thread);
+}
+
+static void ck_search_resume(struct ck_search *search) { // Start a search's thread again from where it got to
+    atomic_store(&search->stop, 0);
+
+    search->thread = ck_thread_start(ck_search_thread, search);
+}
+
+void ck_search_start(struct ck_search *search, struct ck_view *view, const char *needle, size_t len) { // Start searching a view's file for `len' chars of `needle' in the background, and have ck_view_draw() highlight the matches (reversed; change `highlight' for something else), stopping any search already on it
+    if(view->search != NULL) // Only one at a time (stopped the way ck_view_close() does)
+        ck_search_stop(view->search);
+
+    search->view = view,
+    search->len = len,
+    search->highlight = (struct ck_cell){' ', CK_COLOUR_DEFAULT, CK_COLOUR_DEFAULT, CK_ATTR_REVERSE};
+
+    memset(search->blocks, 0, sizeof(search->blocks));
+
+    // Keep a copy of the needle:
+
+    if((search->needle = (char *)malloc(len + 1)) == NULL) {
+        perror("Error allocating memory for ck_search needle: ");
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(search->needle, needle, len);
+
+    atomic_store(&search->found, 0);
+    atomic_store(&search->searched, 0);
+
+    view->search = search;
+
+    ck_search_resume(search);
+}
+
+void ck_search_stop(struct ck_search *search) { // Stop a search and free its matches (the view goes back to not highlighting anything)
+    int i;
+
+    ck_search_pause(search);
+
+    if(search->view->search == search)
+        search->view->search = NULL;
+
+    for(i = 0; i < CK_SEARCH_BLOCKS; i++)
+        free(search->blocks[i]),
+        search->blocks[i] = NULL;
+
+    free(search->needle);
+
+    search->needle = NULL;
+}
+
+size_t ck_search_count(struct ck_search *search, _Bool *complete) { // How many matches have been found so far (setting `complete' if that's all of them; can be NULL)
+    if(complete)
+        *complete = atomic_load_explicit(&search->searched, memory_order_acquire) >= search->view->size;
+
+    return atomic_load_explicit(&search->found, memory_order_acquire);
+}
+
+size_t ck_search_match(const struct ck_search *search, size_t i) { // Where match `i' starts (`i' must be below ck_search_count())
+    return *ck_search_slot(search, i);
+}
+
+size_t ck_search_next(struct ck_search *search, size_t offset) { // Which is the first match found so far that starts at or after `offset' (ck_search_count() if none)
+    size_t low = 0,
+           high = ck_search_count(search, NULL),
+           middle;
+
+    while(low < high) {
+        middle = low + (high - low) / 2;
+
+        if(ck_search_match(search, middle) < offset)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+// File views (for browsing logs too big to read in, by mapping them and only ever looking at the part on screen, plus an index of line starts built in the background):
+
+size_t ck_skip_lines(const char *text, size_t len, size_t count, size_t *skipped) { // Where the line after the `count'th newline in `text' starts (or `len' if there aren't that many, with `skipped' set to how many there were), looking a vector at a time
+    size_t i = 0,
+           found = 0;
+    const char *at;
+
+#ifdef CK_SIMD_TYPE
+    unsigned int newlines;
+    int inVector;
+
+    for(; len - i >= CK_SIMD_WIDTH && found < count; i += CK_SIMD_WIDTH) {
+        newlines = ck_simd_mask_equal(ck_simd_load(text + i), '\n');
+
+        if(found + (inVector = ck_popcount(newlines)) < count) {
+            found += inVector;
+            continue;
+        }
+
+        for(; ++found < count; newlines &= newlines - 1); // The one we want is in this vector, so drop the ones before it
+
+        if(skipped)
+            *skipped = found;
+
+        return i + ck_ctz(newlines) + 1;
+    }
+#endif
+
+    for(; found < count && (at = (const char *)memchr(text + i, '\n', len - i)) != NULL; found++)
+        i = at - text + 1;
+
+    if(skipped)
+        *skipped = found;
+
+    return found < count ? len : i;
+}
+
+#define ck_view_checkpoint(view, n) ((view)->index[(n) / CK_VIEW_CHUNK][(n) % CK_VIEW_CHUNK]) /* Where line n * CK_VIEW_CHECKPOINT starts */
+
+#ifndef CK_VIEW_SLICE
+#define CK_VIEW_SLICE (1 << 20) /* Chars the indexing thread looks through between saying how far it's got */
+#endif
+
+static void *ck_view_indexer(void *arg) { // Fill in a view's index of line starts
+    struct ck_view *view = (struct ck_view *)arg;
+    size_t at = atomic_load_explicit(&view->scanned, memory_order_relaxed),
+           counted = atomic_load_explicit(&view->counted, memory_order_relaxed),
+           checkpoints = atomic_load_explicit(&view->checkpoints, memory_order_relaxed),
+           end, next, skipped;
+
+    while(at < view->size && !atomic_load_explicit(&view->stop, memory_order_relaxed)) {
+        end = view->size - at > CK_VIEW_SLICE ? at + CK_VIEW_SLICE : view->size;
+
+        for(; at < end; at = next) {
+            next = at + ck_skip_lines(view->data + at, end - at, checkpoints * CK_VIEW_CHECKPOINT - counted, &skipped),
+            counted += skipped;
+
+            if(counted == checkpoints * CK_VIEW_CHECKPOINT && next < view->size) { // Reached the next checkpoint (unless it's the end, which isn't the start of a line)
+                if(view->index[checkpoints / CK_VIEW_CHUNK] == NULL && (view->index[checkpoints / CK_VIEW_CHUNK] = (size_t *)malloc(CK_VIEW_CHUNK * sizeof(size_t))) == NULL) {
+                    perror("Error allocating memory for ck_view index: ");
+                    exit(EXIT_FAILURE);
+                }
+
+                ck_view_checkpoint(view, checkpoints) = next;
+
+                atomic_store_explicit(&view->checkpoints, ++checkpoints, memory_order_release);
+            }
+        }
+
+        atomic_store_explicit(&view->counted, counted, memory_order_relaxed);
+        atomic_store_explicit(&view->scanned, at, memory_order_release);
+    }
+
+    return NULL;
+}
+
+_Bool ck_view_open(struct ck_view *view, const char *path) { // Open a file to be viewed from its first line, and start indexing its lines in the background (0 if it can't be opened, see ck_map_file())
+    if((view->data = ck_map_file(path, &view->size)) == NULL)
+        return 0;
+
+    // Keep a copy of the path, for reloading:
+
+    if((view->path = (char *)malloc(strlen(path) + 1)) == NULL) {
+        perror("Error allocating memory for ck_view path: ");
+        exit(EXIT_FAILURE);
+    }
+
+    strcpy(view->path, path);
+
+    view->top = 0,
+    view->window = (struct ck_rect){0, 0, 0, 0},
+    view->blocks = (view->size / CK_VIEW_CHECKPOINT + 1) / CK_VIEW_CHUNK + 1; // Enough for a file of nothing but newlines
+
+    // Allocate memory for the index (just its first block, the rest come as they're needed):
+
+    if((view->index = (size_t **)calloc(view->blocks, sizeof(size_t *))) == NULL || (view->index[0] = (size_t *)malloc(CK_VIEW_CHUNK * sizeof(size_t))) == NULL) {
+        perror("Error allocating memory for ck_view index: ");
+        exit(EXIT_FAILURE);
+    }
+
+    view->index[0][0] = 0; // Line 0 is a given
+
+    atomic_store(&view->checkpoints, 1);
+    atomic_store(&view->counted, 0);
+    atomic_store(&view->scanned, 0);
+    atomic_store(&view->stop, 0);
+
+#ifdef __linux__
+    view->watch = view->timer = -1;
+#endif
+
+    view->search = NULL;
+
+    view->indexer = ck_thread_start(ck_view_indexer, view);
+
+    return 1;
+}
+
+void ck_view_close(struct ck_view *view) { // Stop indexing a view (and searching it), and unmap its file
+    size_t i;
+
+#ifdef __linux__
+    if(view->watch >= 0)
+        ck_view_unfollow(view);
+#endif
+
+    if(view->search != NULL)
+        ck_search_stop(view->search);
+
+    atomic_store(&view->stop, 1);
+    ck_thread_join(view->indexer);
+
+    for(i = 0; i < view->blocks; i++)
+        free(view->index[i]);
+
+    free(view->index);
+    free(view->path);
+    ck_unmap_file(view->data, view->size);
+
+    view->index = NULL,
+    view->path = NULL,
+    view->data = NULL;
+}
+
+size_t ck_view_lines(struct ck_view *view, _Bool *complete) { // How many lines have been counted so far (setting `complete' if that's all of them; can be NULL)
+    size_t scanned = atomic_load_explicit(&view->scanned, memory_order_acquire);
+
+    if(complete)
+        *complete = scanned == view->size;
+
+    return atomic_load_explicit(&view->counted, memory_order_relaxed) + (scanned == view->size && view->size && view->data[view->size - 1] != '\n'); // (A last line without a newline still counts)
+}
+
+size_t ck_view_line_at(struct ck_view *view, size_t offset) { // Which line the char at `offset' is on (counting from the nearest checkpoint, or from the start if the index hasn't got that far)
+    size_t low = 0,
+           high = atomic_load_explicit(&view->checkpoints, memory_order_acquire),
+           middle, skipped;
+
+    if(offset > view->size)
+        offset = view->size;
+
+    // Find the last checkpoint at or before `offset', then count the newlines from there:
+
+    while(high - low > 1) {
+        middle = low + (high - low) / 2;
+
+        if(ck_view_checkpoint(view, middle) <= offset)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    ck_skip_lines(view->data + ck_view_checkpoint(view, low), offset - ck_view_checkpoint(view, low), (size_t)-1, &skipped);
+
+    return low * CK_VIEW_CHECKPOINT + skipped;
+}
+
+static size_t ck_view_line_start(const struct ck_view *view, size_t offset) { // Where the line that the char at `offset' is on starts
+    for(; offset && view->data[offset - 1] != '\n'; offset--);
+
+    return offset;
+}
+
+void ck_view_goto_line(struct ck_view *view, size_t line) { // Put line `line' (from 0) at the top of the window (or the last line, if there aren't that many)
+    size_t checkpoint = line / CK_VIEW_CHECKPOINT,
+           checkpoints = atomic_load_explicit(&view->checkpoints, memory_order_acquire),
+           from;
+
+    if(checkpoint >= checkpoints)
+        checkpoint = checkpoints - 1;
+
+    from = ck_view_checkpoint(view, checkpoint);
+
+    if((view->top = from + ck_skip_lines(view->data + from, view->size - from, line - checkpoint * CK_VIEW_CHECKPOINT, NULL)) == view->size) // Past the last line
+        view->top = ck_view_line_start(view, view->size && view->data[view->size - 1] == '\n' ? view->size - 1 : view->size);
+}
+
+void ck_view_goto_offset(struct ck_view *view, size_t offset) { // Put the line that the char at `offset' is on at the top of the window
+    if(offset >= view->size) // (The end of the file is on the last line, not after it)
+        offset = view->size && view->data[view->size - 1] == '\n' ? view->size - 1 : view->size;
+
+    view->top = ck_view_line_start(view, offset);
+}
+
+void ck_view_scroll(struct ck_view *view, long amount) { // Move the window down by `amount' lines (up if negative), stopping at either end of the file
+    size_t next;
+
+    for(; amount < 0 && view->top; amount++)
+        view->top = ck_view_line_start(view, view->top - 1);
+
+    if(amount > 0 && (next = view->top + ck_skip_lines(view->data + view->top, view->size - view->top, amount, NULL)) < view->size)
+        view->top = next;
+    else if(amount > 0)
+        ck_view_goto_offset(view, view->size);
+}
+
+static size_t ck_write_line(const char *text, size_t len, size_t columns, size_t width) { // Write (part of) a line to the CK_SCREEN_BUFFER from column `columns', cut off at `width' columns, returning which column it got to (tabs are expanded, and control chars shown as `?' so they can't mess with the terminal)
+    size_t i = 0,
+           run, used;
+    unsigned int glyph;
+    int glyphWidth;
+    _Bool control;
+
+    while(i < len && columns < width) {
+        // Printable ASCII goes straight through:
+
+        if((run = ck_ascii_span(text + i, len - i < width - columns ? len - i : width - columns))) {
+            ck_write(text + i, run);
+
+            i += run,
+            columns += run;
+
+            continue;
+        }
+
+        if(text[i] == '\t') {
+            run = 8 - columns % 8 < width - columns ? 8 - columns % 8 : width - columns;
+
+            ck_write("        ", run);
+
+            i++,
+            columns += run;
+
+            continue;
+        }
+
+        // Anything else is decoded to find out how wide it is:
+
+        glyph = ck_utf8_decode(text + i, len - i, &used),
+        control = glyph < 0x20 || glyph == 0x7F || (glyph >= 0x80 && glyph < 0xA0),
+        glyphWidth = control ? 1 : ck_glyph_width(glyph);
+
+        if(columns + glyphWidth > width)
+            break;
+
+        if(control)
+            ck_write("?", 1);
+        else if(glyph == 0xFFFD && used == 1) // Malformed, so written as the replacement char rather than as is
+            ck_write("\xEF\xBF\xBD", 3);
+        else
+            ck_write(text + i, used);
+
+        i += used,
+        columns += glyphWidth;
+    }
+
+    return columns;
+}
+
+static void ck_view_write_rows(struct ck_view *view, size_t at, size_t row) { // Write the window's rows from `row' down, starting with the line at `at'
+    static const struct ck_cell plain = {' ', CK_COLOUR_DEFAULT, CK_COLOUR_DEFAULT, 0};
+    struct ck_sgr_state state = {CK_COLOUR_DEFAULT, CK_COLOUR_DEFAULT, 0, 1};
+    char sgr[64];
+    size_t end, columns, from, to, match, count;
+    const char *newline;
+
+    if(view->search != NULL) // Matches are highlighted by switching formatting from the default and back
+        ck_print(CK_RESET_FORMATTING);
+
+    for(; row < view->window.height; row++) {
+        ck_print(ck_cursor_goto(view->window.x + 1, view->window.y + row + 1));
+
+        columns = 0;
+
+        if(at < view->size) {
+            end = (newline = (const char *)memchr(view->data + at, '\n', view->size - at)) != NULL ? (size_t)(newline - view->data) : view->size,
+            end -= end > at && view->data[end - 1] == '\r';
+
+            // Write it a piece at a time, between the starts and ends of any matches on it:
+
+            if(view->search != NULL)
+                for(match = ck_search_next(view->search, at - (at > view->search->len ? view->search->len : at)), count = ck_search_count(view->search, NULL), from = at; columns < view->window.width; match++) {
+                    if(match < count && (to = ck_search_match(view->search, match)) < end) {
+                        if(to + view->search->len <= from) // Ends before the line does
+                            continue;
+
+                        if(to > from)
+                            columns = ck_write_line(view->data + from, to - from, columns, view->window.width);
+
+                        from = to > from ? to : from,
+                        to = to + view->search->len < end ? to + view->search->len : end;
+
+                        ck_write(sgr, ck_sgr(sgr, &state, &view->search->highlight));
+
+                        columns = ck_write_line(view->data + from, to - from, columns, view->window.width),
+                        from = to;
+
+                        ck_write(sgr, ck_sgr(sgr, &state, &plain));
+                    } else {
+                        columns = ck_write_line(view->data + from, end - from, columns, view->window.width);
+
+                        break;
+                    }
+                }
+            else
+                columns = ck_write_line(view->data + at, end - at, 0, view->window.width);
+
+            at = (newline != NULL ? (size_t)(newline - view->data) : view->size) + 1;
+        }
+
+        if(columns < view->window.width)
+            ck_print(ck_cursor_move('X', view->window.width - columns)); // Erase the rest (without moving, so nothing scrolls at the bottom-right)
+    }
+}
+
+void ck_view_draw(struct ck_view *view, size_t x, size_t y, size_t width, size_t height) { // Write the lines in the window to the CK_SCREEN_BUFFER, into the rectangle at (x, y) (0-based; lines are cut off at `width' columns, and anything left over is erased)
+    view->window = (struct ck_rect){x, y, width, height};
+
+    ck_view_write_rows(view, view->top, 0);
+}
+
+int ck_view_reload(struct ck_view *view) { // Remap the view's file if it's grown, carrying on indexing from where it got to, or start again from the top if it's been replaced (as when a log is rotated), returning 1 or 2 respectively (0 if neither)
+    const char *data;
+    size_t size, blocks, i,
+           compare;
+    _Bool replaced;
+
+    if((data = ck_map_file(view->path, &size)) == NULL) // (Say it's been rotated away and not recreated yet; try again next time)
+        return 0;
+
+    if(size == view->size) {
+        ck_unmap_file(data, size);
+
+        return 0;
+    }
+
+    // It's a different file if it's shrunk, or doesn't start or end with what it used to (checking all of it would mean reading the whole thing again):
+
+    compare = view->size < CK_VIEW_COMPARE ? view->size : CK_VIEW_COMPARE,
+    replaced = size < view->size || memcmp(data, view->data, compare) || memcmp(data + view->size - compare, view->data + view->size - compare, compare);
+
+    // The indexing and searching threads have to stop while the old mapping goes away:
+
+    atomic_store(&view->stop, 1);
+    ck_thread_join(view->indexer);
+
+    if(view->search != NULL)
+        ck_search_pause(view->search);
+
+    ck_unmap_file(view->data, view->size);
+
+    if(replaced) { // Nothing already indexed (or found) still holds
+        for(i = 1; i < view->blocks; i++)
+            free(view->index[i]),
+            view->index[i] = NULL;
+
+        atomic_store(&view->checkpoints, 1);
+        atomic_store(&view->counted, 0);
+        atomic_store(&view->scanned, 0);
+
+        if(view->search != NULL)
+            atomic_store(&view->search->found, 0),
+            atomic_store(&view->search->searched, 0);
+
+        view->top = 0;
+    }
+
+    view->data = data,
+    view->size = size;
+
+    // Make room in the index for a bigger file:
+
+    if((blocks = (size / CK_VIEW_CHECKPOINT + 1) / CK_VIEW_CHUNK + 1) > view->blocks) {
+        if((CK_ALLOC_BUFFER = (void *)realloc(view->index, blocks * sizeof(size_t *))) == NULL) {
+            perror("Error reallocating memory for ck_view index: ");
+            exit(EXIT_FAILURE);
+        }
+
+        view->index = (size_t **)CK_ALLOC_BUFFER;
+
+        memset(view->index + view->blocks, 0, (blocks - view->blocks) * sizeof(size_t *));
+
+        view->blocks = blocks;
+    }
+
+    atomic_store(&view->stop, 0);
+
+    view->indexer = ck_thread_start(ck_view_indexer, view);
+
+    if(view->search != NULL)
+        ck_search_resume(view->search);
+
+    return replaced ? 2 : 1;
+}
+
+void ck_view_update(struct ck_view *view) { // ck_view_reload(), and if the window was showing the end of the file, keep it there by scrolling what's on screen up and writing only the new lines (a window that isn't the full width of CK_GRID gets rewritten instead, since the terminal can only scroll whole rows, as does any window while CK_GRID hasn't been sized)
+    size_t oldSize = view->size,
+           height = view->window.height,
+           first, row, newLines, rows, amount;
+    int change;
+    _Bool atEnd = ck_skip_lines(view->data + view->top, view->size - view->top, height, NULL) == view->size - view->top; // Fewer lines left than fit in the window
+
+    if(!(change = ck_view_reload(view)))
+        return;
+
+    if(change == 2) { // Started again from the top
+        ck_view_write_rows(view, 0, 0);
+
+        return;
+    }
+
+    if(!atEnd)
+        return;
+
+    // Find the first line that's changed (the one that was last, if it hadn't got its newline yet) and which row it's on, and how many rows there are now:
+
+    first = ck_view_line_start(view, oldSize);
+
+    ck_skip_lines(view->data + view->top, first - view->top, (size_t)-1, &row);
+    ck_skip_lines(view->data + first, view->size - first, (size_t)-1, &newLines);
+
+    if((rows = row + newLines + (view->data[view->size - 1] != '\n')) <= height) { // All still fits
+        ck_view_write_rows(view, first, row);
+
+        return;
+    }
+
+    // Scroll what's still going to be on screen up, and write what's below it:
+
+    view->top += ck_skip_lines(view->data + view->top, view->size - view->top, amount = rows - height, NULL);
+
+    if(amount < height && row >= amount && !view->window.x && CK_GRID.width && view->window.width >= CK_GRID.width) { // (CK_GRID being how wide the terminal's known to be)
+        ck_write_scroll(view->window.y, height, amount);
+
+        if(CK_GRID_DISPLAYED.width == CK_GRID.width && CK_GRID_DISPLAYED.height == CK_GRID.height) // Keep ck_present() up to date, as ck_scroll() does
+            ck_grid_scroll(&CK_GRID_DISPLAYED, view->window.y, height, amount);
+
+        ck_view_write_rows(view, first, row - amount);
+    } else
+        ck_view_write_rows(view, view->top, 0);
+}
+
+// Tables (where only the rows on screen are ever drawn, and their columns' widths are kept up to date a row at a time):
+
+static void ck_table_count(struct ck_table *table, size_t row, int change) { // Add (`change' 1) or take away (-1) a row's cells from its columns' counts of widths (`row' is 0 for the titles, from 1 for rows)
+    size_t column, width,
+           *counts;
+
+    for(column = 0; column < table->columns; column++) {
+        width = table->widths[row * table->columns + column],
+        counts = table->counts + column * (CK_TABLE_WIDEST + 1);
+
+        if((counts[width] += change) && width > table->widest[column])
+            table->widest[column] = width;
+        else if(!counts[width] && width == table->widest[column]) // Was the widest, so find the next one down
+            for(; table->widest[column] && !counts[table->widest[column]]; table->widest[column]--);
+    }
+}
+
+static void ck_table_measure(struct ck_table *table, size_t row) { // Find how wide each of a row's cells is (`row' is 0 for the titles, from 1 for rows)
+    size_t column, len, width;
+    const char *text;
+
+    for(column = 0; column < table->columns; column++)
+        text = table->cell(row - 1, column, &len, table->data), // (CK_TABLE_HEADER for the titles)
+        width = ck_utf8_width(text, len),
+        table->widths[row * table->columns + column] = width < CK_TABLE_WIDEST ? width : CK_TABLE_WIDEST;
+}
+
+void ck_table_init(struct ck_table *table, size_t columns, ck_table_callback cell, void *data) { // Set up an empty table with `columns' columns, whose cells' text comes from `cell' (asked for row CK_TABLE_HEADER to get the titles)
+    table->cell = cell,
+    table->data = data,
+    table->rows = 0,
+    table->columns = columns,
+    table->order = NULL,
+    table->top = 0,
+    table->header = (struct ck_cell){' ', CK_COLOUR_DEFAULT, CK_COLOUR_DEFAULT, CK_ATTR_BOLD};
+
+    // Allocate memory for the titles' widths and the counts (room for a column even if there are none, as malloc(0) can give NULL):
+
+    if(!columns)
+        columns = 1;
+
+    if((table->widths = (unsigned char *)malloc(columns)) == NULL || (table->counts = (size_t *)calloc(columns * (CK_TABLE_WIDEST + 1), sizeof(size_t))) == NULL || (table->widest = (size_t *)calloc(columns, sizeof(size_t))) == NULL) {
+        perror("Error allocating memory for ck_table: ");
+        exit(EXIT_FAILURE);
+    }
+
+    ck_table_measure(table, 0);
+    ck_table_count(table, 0, 1);
+}
+
+void ck_table_free(struct ck_table *table) {
+    free(table->widths);
+    free(table->counts);
+    free(table->widest);
+    free(table->order);
+
+    table->widths = NULL,
+    table->counts = table->widest = table->order = NULL;
+}
+
+void ck_table_resize(struct ck_table *table, size_t rows) { // Change how many rows a table has (new ones are measured and go at the end, whatever order it's in)
+    size_t row, i, kept;
+
+    for(row = rows; row < table->rows; row++) // Rows that are going away
+        ck_table_count(table, row + 1, -1);
+
+    // Take rows that are going away out of the order:
+
+    if(rows < table->rows) {
+        for(i = kept = 0; i < table->rows; i++)
+            if(table->order[i] < rows)
+                table->order[kept++] = table->order[i];
+
+        if(table->top >= rows)
+            table->top = rows ? rows - 1 : 0;
+    }
+
+    // Make room for new ones:
+
+    if((CK_ALLOC_BUFFER = (void *)realloc(table->widths, (rows + 1) * (table->columns ? table->columns : 1))) == NULL) {
+        perror("Error reallocating memory for ck_table widths: ");
+        exit(EXIT_FAILURE);
+    }
+
+    table->widths = (unsigned char *)CK_ALLOC_BUFFER;
+
+    if((CK_ALLOC_BUFFER = (void *)realloc(table->order, (rows ? rows : 1) * sizeof(size_t))) == NULL) {
+        perror("Error reallocating memory for ck_table order: ");
+        exit(EXIT_FAILURE);
+    }
+
+    table->order = (size_t *)CK_ALLOC_BUFFER;
+
+    for(row = table->rows; row < rows; row++)
+        table->order[row] = row,
+        ck_table_measure(table, row + 1),
+        ck_table_count(table, row + 1, 1);
+
+    table->rows = rows;
+}
+
+void ck_table_changed(struct ck_table *table, size_t row) { // Measure a row again after its text has changed (or the titles, for CK_TABLE_HEADER)
+    ck_table_count(table, row + 1, -1);
+    ck_table_measure(table, row + 1);
+    ck_table_count(table, row + 1, 1);
+}
+
+void ck_table_sort(struct ck_table *table, ck_table_compare compare, void *data) { // Put a table's rows in order by `compare' (rows that compare equal keep the order they were in, so sorting by one column then another sorts by both), without moving them
+    size_t *from = table->order,
+           *to, *swap,
+           run, start, middle, end, i, j, k;
+
+    if(table->rows < 2)
+        return;
+
+    if((to = (size_t *)malloc(table->rows * sizeof(size_t))) == NULL) {
+        perror("Error allocating memory for ck_table sort: ");
+        exit(EXIT_FAILURE);
+    }
+
+    // Merge sort, merging runs of 1, then 2, 4... back and forth between the order and a copy:
+
+    for(run = 1; run < table->rows; run *= 2, swap = from, from = to, to = swap)
+        for(start = 0; start < table->rows; start = end) {
+            middle = table->rows - start > run ? start + run : table->rows,
+            end = table->rows - middle > run ? middle + run : table->rows;
+
+            for(i = k = start, j = middle; k < end; k++)
+                to[k] = j >= end || (i < middle && compare(from[i], from[j], data) <= 0) ? from[i++] : from[j++];
+        }
+
+    if(from != table->order) // Ended up in the copy
+        memcpy(table->order, from, table->rows * sizeof(size_t)),
+        to = from;
+
+    free(to);
+}
+
+void ck_table_scroll(struct ck_table *table, long amount) { // Move the window down by `amount' rows (up if negative), stopping at either end of the table
+    if(amount < 0)
+        table->top = (size_t)-amount < table->top ? table->top + amount : 0;
+    else
+        table->top = table->rows - table->top > (size_t)amount ? table->top + amount : (table->rows ? table->rows - 1 : 0);
+}
+
+void ck_table_draw(struct ck_table *table, size_t x, size_t y, size_t width, size_t height) { // Write the titles and the rows in the window to the CK_SCREEN_BUFFER, into the rectangle at (x, y) (0-based; cells are cut off at the width of their column, and the row at that of the rectangle)
+    static const struct ck_cell plain = {' ', CK_COLOUR_DEFAULT, CK_COLOUR_DEFAULT, 0};
+    static const char spaces[] = "                ";
+    struct ck_sgr_state state = {0, 0, 0, 0};
+    char sgr[64];
+    size_t i, row, column, start, stop, columns, len, pad;
+    const char *text;
+
+    for(i = 0; i < height; i++) {
+        ck_print(ck_cursor_goto(x + 1, y + i + 1));
+
+        columns = 0;
+
+        if(i < 2) // Titles are in their own formatting, and rows in the default
+            ck_write(sgr, ck_sgr(sgr, &state, i ? &plain : &table->header));
+
+        if(i && table->top + i - 1 >= table->rows) { // Past the last row
+            ck_print(ck_cursor_move('X', width));
+
+            continue;
+        }
+
+        row = i ? table->order[table->top + i - 1] : CK_TABLE_HEADER;
+
+        for(column = 0; column < table->columns && columns < width; column++) {
+            start = columns,
+            stop = width - start > table->widest[column] ? start + table->widest[column] : width,
+            text = table->cell(row, column, &len, table->data),
+            columns = ck_write_line(text, len, columns, stop);
+
+            // Pad it out to the start of the next column (with spaces rather than erasing, so the titles' formatting covers the gaps):
+
+            if(column + 1 < table->columns)
+                stop = width - stop > CK_TABLE_GAP ? stop + CK_TABLE_GAP : width;
+
+            for(; columns < stop; columns += pad)
+                pad = stop - columns < sizeof(spaces) - 1 ? stop - columns : sizeof(spaces) - 1,
+                ck_write(spaces, pad);
+        }
+
+        if(columns < width)
+            ck_print(ck_cursor_move('X', width - columns)); // Erase the rest (without moving, so nothing scrolls at the bottom-right)
+    }
+
+    if(height == 1) // Only the titles fit
+        ck_write(sgr, ck_sgr(sgr, &state, &plain));
+}
+
+// Progress bars (which worker threads update with atomics, and the window samples at its own rate, only writing what's changed):
+
+static const char CK_PROGRESS_EIGHTHS[9][4] = {" ", "\xE2\x96\x8F", "\xE2\x96\x8E", "\xE2\x96\x8D", "\xE2\x96\x8C", "\xE2\x96\x8B", "\xE2\x96\x8A", "\xE2\x96\x89", "\xE2\x96\x88"}; // Empty to full cells, in eighths
+
+void ck_progress_init(struct ck_progress *progress, size_t count) { // Set up `count' progress bars (with no labels, and totals of 100)
+    size_t i;
+
+    if((progress->bars = (struct ck_progress_bar *)malloc((count ? count : 1) * sizeof(struct ck_progress_bar))) == NULL) {
+        perror("Error allocating memory for ck_progress bars: ");
+        exit(EXIT_FAILURE);
+    }
+
+    for(i = 0; i < count; i++) {
+        progress->bars[i].label = NULL,
+        progress->bars[i].progress = progress,
+        progress->bars[i].drawn = (size_t)-1,
+        progress->bars[i].percent = 0;
+
+        atomic_store(&progress->bars[i].done, 0);
+        atomic_store(&progress->bars[i].total, 100);
+        atomic_store(&progress->bars[i].counted, 0);
+    }
+
+    atomic_store(&progress->finished, 0);
+    atomic_store(&progress->sum, 0);
+
+    progress->count = count,
+    progress->top = 0,
+    progress->window = (struct ck_rect){0, 0, 0, 0},
+    progress->labelWidth = progress->barWidth = 0,
+    progress->summary[0] = '\0';
+
+#ifdef __linux__
+    progress->timer = -1;
+#endif
+}
+
+void ck_progress_free(struct ck_progress *progress) {
+#ifdef __linux__
+    if(progress->timer >= 0)
+        ck_progress_stop(progress);
+#endif
+
+    free(progress->bars);
+
+    progress->bars = NULL;
+}
+
+void ck_progress_scroll(struct ck_progress *progress, long amount) { // Move the window down by `amount' bars (up if negative), stopping at either end (call ck_progress_draw() again after)
+    if(amount < 0)
+        progress->top = (size_t)-amount < progress->top ? progress->top + amount : 0;
+    else
+        progress->top = progress->count - progress->top > (size_t)amount ? progress->top + amount : (progress->count ? progress->count - 1 : 0);
+}
+
+static size_t ck_progress_shown(const struct ck_progress *progress) { // How many bars fit in the window (leaving room for the summary line if they don't all)
+    size_t left = progress->count - (progress->top < progress->count ? progress->top : progress->count);
+
+    if(progress->count <= progress->window.height && !progress->top) // All of them
+        return progress->count;
+
+    if(!progress->window.height)
+        return 0;
+
+    return left < progress->window.height - 1 ? left : progress->window.height - 1;
+}
+
+static void ck_progress_sample(const struct ck_progress *progress, const struct ck_progress_bar *bar, size_t *eighths, unsigned int *percent) { // How much of a bar is filled in (in eighths of a cell) and what percentage it's at
+    size_t done = atomic_load_explicit(&bar->done, memory_order_relaxed),
+           total = atomic_load_explicit(&bar->total, memory_order_relaxed);
+    double fraction = !total ? 0 : done >= total ? 1 : (double)done / total;
+
+    *eighths = (size_t)(fraction * progress->barWidth * 8),
+    *percent = (unsigned int)(fraction * 100);
+}
+
+static void ck_progress_write_cells(size_t eighths, size_t from, size_t to) { // Write cells `from' to `to' of a bar with `eighths' filled in
+    for(; from < to; from++)
+        ck_print(CK_PROGRESS_EIGHTHS[from < eighths / 8 ? 8 : from == eighths / 8 ? eighths % 8 : 0]);
+}
+
+static void ck_progress_write_percent(const struct ck_progress *progress, size_t row, unsigned int percent) { // Write a bar's percentage at the end of its row
+    char text[8];
+
+    ck_print(ck_cursor_goto(progress->window.x + progress->window.width - 3, progress->window.y + row + 1));
+    ck_write(text, sprintf(text, "%3u%%", percent));
+}
+
+void ck_progress_recount(struct ck_progress_bar *bar) { // Bring a bar's share of its ck_progress's running totals up to date (ck_progress_add() and the like do this themselves)
+    size_t done = atomic_load_explicit(&bar->done, memory_order_relaxed),
+           total = atomic_load_explicit(&bar->total, memory_order_relaxed),
+           counted = (!total ? 0 : done >= total ? CK_PROGRESS_UNITS : (size_t)((double)done / total * CK_PROGRESS_UNITS)) * 2 + (total && done >= total),
+           old;
+
+    if(counted == atomic_load_explicit(&bar->counted, memory_order_relaxed)) // Most updates don't change it (so don't touch the shared totals)
+        return;
+
+    // Swapping it in means what's taken back off is exactly what was added before, even with two threads at it at once, so the totals never drift (the differences wrap around when negative, which adding undoes):
+
+    old = atomic_exchange_explicit(&bar->counted, counted, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&bar->progress->finished, (counted & 1) - (old & 1), memory_order_relaxed);
+    atomic_fetch_add_explicit(&bar->progress->sum, counted / 2 - old / 2, memory_order_relaxed);
+}
+
+static void ck_progress_write_summary(struct ck_progress *progress, size_t shown) { // Write the line summing up the bars that aren't shown, if it's changed
+    size_t i, counted,
+           hidden = progress->count - shown,
+           finished = atomic_load_explicit(&progress->finished, memory_order_relaxed),
+           sum = atomic_load_explicit(&progress->sum, memory_order_relaxed);
+    char text[sizeof(progress->summary)];
+    size_t columns;
+
+    if(progress->summary[0] && finished == progress->summed[0] && sum == progress->summed[1]) // No bar has changed
+        return;
+
+    progress->summed[0] = finished,
+    progress->summed[1] = sum;
+
+    // Take away the bars that are shown (a bar caught between swapping in its share and adding it could take away more than's there):
+
+    for(i = progress->top; i < progress->top + shown; i++)
+        counted = atomic_load_explicit(&progress->bars[i].counted, memory_order_relaxed),
+        finished -= finished ? counted & 1 : 0,
+        sum -= sum > counted / 2 ? counted / 2 : sum;
+
+    if(finished > hidden) // (Or less, if it's gone down)
+        finished = hidden;
+
+    if(sum > hidden * CK_PROGRESS_UNITS)
+        sum = hidden * CK_PROGRESS_UNITS;
+
+    snprintf(text, sizeof(text), "%zu more: %zu finished, %u%% done", hidden, finished, hidden ? (unsigned int)((double)sum * 100 / CK_PROGRESS_UNITS / hidden) : 0);
+
+    if(!strcmp(text, progress->summary))
+        return;
+
+    strcpy(progress->summary, text);
+
+    ck_print(ck_cursor_goto(progress->window.x + 1, progress->window.y + progress->window.height));
+
+    if((columns = ck_write_line(text, strlen(text), 0, progress->window.width)) < progress->window.width)
+        ck_print(ck_cursor_move('X', progress->window.width - columns));
+}
+
+void ck_progress_draw(struct ck_progress *progress, size_t x, size_t y, size_t width, size_t height) { // Write the bars in the window to the CK_SCREEN_BUFFER, into the rectangle at (x, y) (0-based; if they don't all fit, the bottom row sums up the ones that don't)
+    size_t i, row, shown, columns, len;
+    struct ck_progress_bar *bar;
+
+    progress->window = (struct ck_rect){x, y, width, height},
+    shown = ck_progress_shown(progress);
+
+    // Labels get up to a third of the width, and the percentages 4 columns (each with a space after):
+
+    for(i = 0, progress->labelWidth = 0; i < shown; i++)
+        if(progress->bars[progress->top + i].label != NULL && (len = ck_utf8_width(progress->bars[progress->top + i].label, strlen(progress->bars[progress->top + i].label))) > progress->labelWidth)
+            progress->labelWidth = len;
+
+    if(progress->labelWidth > width / 3)
+        progress->labelWidth = width / 3;
+
+    progress->barWidth = width > progress->labelWidth + (progress->labelWidth > 0) + 5 ? width - progress->labelWidth - (progress->labelWidth > 0) - 5 : 0;
+
+    for(row = 0; row < height; row++) {
+        ck_print(ck_cursor_goto(x + 1, y + row + 1));
+
+        if(row >= shown || !progress->barWidth) { // Nothing (or no room)
+            ck_print(ck_cursor_move('X', width));
+
+            continue;
+        }
+
+        bar = progress->bars + progress->top + row,
+        columns = 0;
+
+        if(progress->labelWidth) {
+            if(bar->label != NULL)
+                columns = ck_write_line(bar->label, strlen(bar->label), 0, progress->labelWidth);
+
+            if(columns <= progress->labelWidth)
+                ck_print(ck_cursor_move('X', progress->labelWidth + 1 - columns)),
+                ck_print(ck_cursor_move('C', progress->labelWidth + 1 - columns));
+        }
+
+        ck_progress_sample(progress, bar, &bar->drawn, &bar->percent);
+        ck_progress_write_cells(bar->drawn, 0, progress->barWidth);
+        ck_print(" ");
+        ck_progress_write_percent(progress, row, bar->percent);
+    }
+
+    progress->summary[0] = '\0';
+
+    if(shown < progress->count && height)
+        ck_progress_write_summary(progress, shown);
+}
+
+void ck_progress_update(struct ck_progress *progress) { // Write only the parts of the window that have changed since it was last drawn (bars whose filled-in width or percentage is different, and the summary line if its text is), to be called at a fixed rate however often the tasks update
+    size_t row, eighths, from, to,
+           shown = ck_progress_shown(progress),
+           barX = progress->window.x + progress->labelWidth + (progress->labelWidth > 0);
+    unsigned int percent;
+    struct ck_progress_bar *bar;
+
+    if(!progress->barWidth)
+        return;
+
+    for(row = 0; row < shown; row++) {
+        bar = progress->bars + progress->top + row;
+
+        ck_progress_sample(progress, bar, &eighths, &percent);
+
+        // Only the cells between where it used to end and where it ends now:
+
+        if(eighths != bar->drawn) {
+            from = (eighths < bar->drawn ? eighths : bar->drawn) / 8,
+            to = (eighths > bar->drawn ? eighths : bar->drawn) / 8 + 1;
+
+            if(to > progress->barWidth)
+                to = progress->barWidth;
+
+            ck_print(ck_cursor_goto(barX + from + 1, progress->window.y + row + 1));
+            ck_progress_write_cells(eighths, from, to);
+
+            bar->drawn = eighths;
+        }
+
+        if(percent != bar->percent)
+            ck_progress_write_percent(progress, row, bar->percent = percent);
+    }
+
+    if(shown < progress->count && progress->window.height)
+        ck_progress_write_summary(progress, shown);
+}
+
+// Input decoding:
+
+static const char *ck_find_paste_end(const char *text, size_t len) { // Find the `CSI 201 ~' that ends a paste, picking up from where the last search left off (NULL if it hasn't arrived yet)
+    const char *at = text + CK_PASTE_SEARCHED;
+
+    for(; (at = (const char *)memchr(at, '\033', text + len - at)) != NULL; at++)
+        if(text + len - at < 6)
+            break;
+        else if(!memcmp(at, "\033[201~", 6))
+            return CK_PASTE_SEARCHED = 0, at;
+
+    CK_PASTE_SEARCHED = len > 5 ? len - 5 : 0; // The end marker might have been cut off
+
+    return NULL;
+}
+
+size_t ck_parse_input(const char *in, size_t len, struct ck_event *event) { // Decode the key at the start of `in', returning how many chars it took up (0 if it's incomplete)
+    static const unsigned int tildeKeys[] = {0, CK_KEY_HOME, CK_KEY_INSERT, CK_KEY_DELETE, CK_KEY_END, CK_KEY_PAGE_UP, CK_KEY_PAGE_DOWN, CK_KEY_HOME, CK_KEY_END, 0, 0, // `CSI n ~' for n up to 10
+                                             CK_KEY_F(1), CK_KEY_F(2), CK_KEY_F(3), CK_KEY_F(4), CK_KEY_F(5), 0, CK_KEY_F(6), CK_KEY_F(7), CK_KEY_F(8), CK_KEY_F(9), CK_KEY_F(10), 0, CK_KEY_F(11), CK_KEY_F(12)};
+    unsigned int params[3] = {0, 0, 0};
+    const char *end;
+    size_t used, i,
+           count = 0;
+
+    memset(event, 0, sizeof(*event));
+
+    event->type = CK_EVENT_KEY;
+
+    if(in[0] != '\033') {
+        if((unsigned char)in[0] >= 0xC0 && len < (size_t)((unsigned char)in[0] >= 0xF0 ? 4 : (unsigned char)in[0] >= 0xE0 ? 3 : 2)) // Rest of the character hasn't been read yet
+            return 0;
+
+        event->key = ck_utf8_decode(in, len, &used);
+
+        return used;
+    }
+
+    // A lone escape is the escape key (terminals send whole sequences at once, so there's no need to wait for more):
+
+    if(len == 1)
+        return event->key = '\033', 1;
+
+    // Escape followed by anything but a sequence is that key with alt held:
+
+    if(in[1] != '[' && in[1] != 'O') {
+        used = ck_parse_input(in + 1, len - 1, event);
+        event->modifiers |= CK_MOD_ALT;
+
+        return used ? used + 1 : 0;
+    }
+
+    if(len == 2)
+        return 0;
+
+    // SS3 (`ESC O x'), sent for F1 to F4 and sometimes arrows:
+
+    if(in[1] == 'O') {
+        switch(in[2]) {
+            case 'A': event->key = CK_KEY_UP; break;
+            case 'B': event->key = CK_KEY_DOWN; break;
+            case 'C': event->key = CK_KEY_RIGHT; break;
+            case 'D': event->key = CK_KEY_LEFT; break;
+            case 'H': event->key = CK_KEY_HOME; break;
+            case 'F': event->key = CK_KEY_END; break;
+            case 'P': case 'Q': case 'R': case 'S': event->key = CK_KEY_F(in[2] - 'P' + 1);
+        }
+
+        if(!event->key)
+            event->type = 0;
+
+        return 3;
+    }
+
+    // CSI (`ESC [ params final'), with the parameters parsed in place:
+
+    for(i = 2; i < len && (unsigned char)in[i] >= 0x20 && (unsigned char)in[i] < 0x40; i++)
+        if(in[i] == ';')
+            count++;
+        else if(in[i] >= '0' && in[i] <= '9' && count < 3)
+            params[count] = params[count] * 10 + in[i] - '0';
+
+    if(i == len)
+        return i > 64 ? len : 0; // Unterminated, so wait for the rest (unless it's garbage)
+
+    // Bracketed paste (`CSI 200 ~', the text, then `CSI 201 ~'), which could be megabytes, so is searched for the end a chunk at a time:
+
+    if(in[i] == '~' && params[0] == 200 && count == 0) {
+        if((end = ck_find_paste_end(in + i + 1, len - i - 1)) == NULL)
+            return 0;
+
+        event->type = CK_EVENT_PASTE,
+        event->text = in + i + 1,
+        event->len = end - event->text;
+
+        return end + 6 - in;
+    }
+
+    // SGR mouse report (`CSI < button;x;y M', or `m' for a release), where the button has flags for motion (32), the wheel (64), and modifiers (4 shift, 8 alt, 16 ctrl):
+
+    if(in[2] == '<') {
+        if(in[i] != 'M' && in[i] != 'm') {
+            event->type = 0;
+            return i + 1;
+        }
+
+        event->type = in[i] == 'm' ? CK_EVENT_MOUSE_UP : params[0] & 32 ? CK_EVENT_MOUSE_MOVE : CK_EVENT_MOUSE_DOWN,
+        event->key = params[0] & 64 ? (params[0] & 3) < 2 ? CK_MOUSE_WHEEL_UP + (params[0] & 1) : CK_MOUSE_NONE :
+                     (params[0] & 3) == 3 ? CK_MOUSE_NONE : (params[0] & 3) + CK_MOUSE_LEFT,
+        event->modifiers = (params[0] & 4 ? CK_MOD_SHIFT : 0) | (params[0] & 8 ? CK_MOD_ALT : 0) | (params[0] & 16 ? CK_MOD_CTRL : 0),
+        event->x = params[1] ? params[1] - 1 : 0,
+        event->y = params[2] ? params[2] - 1 : 0;
+
+        return i + 1;
+    }
+
+    if(params[1] > 1) // `CSI 1;m x' has the modifiers + 1 in `m'
+        event->modifiers = (params[1] - 1) & (CK_MOD_SHIFT | CK_MOD_ALT | CK_MOD_CTRL);
+
+    switch(in[i]) {
+        case 'A': event->key = CK_KEY_UP; break;
+        case 'B': event->key = CK_KEY_DOWN; break;
+        case 'C': event->key = CK_KEY_RIGHT; break;
+        case 'D': event->key = CK_KEY_LEFT; break;
+        case 'H': event->key = CK_KEY_HOME; break;
+        case 'F': event->key = CK_KEY_END; break;
+        case 'P': case 'Q': case 'R': case 'S': event->key = CK_KEY_F(in[i] - 'P' + 1); break;
+        case 'Z': event->key = '\t', event->modifiers |= CK_MOD_SHIFT; break; // Shift+tab
+        case '~':
+            if(params[0] < sizeof(tildeKeys) / sizeof(tildeKeys[0]))
+                event->key = tildeKeys[params[0]];
+    }
+
+    if(!event->key)
+        event->type = 0;
+
+    return i + 1;
+}
+
+static char *ck_reserve_input(size_t len) { // Make room for `len' more chars at the end of CK_INPUT_BUFFER, returning where they go
+    // Automatic reallocation if needed:
+
+    if(CK_INPUT_BUFFER_END + len > CK_INPUT_BUFFER_SIZE) {
+        while(CK_INPUT_BUFFER_END + len > CK_INPUT_BUFFER_SIZE)
+            CK_INPUT_BUFFER_SIZE += CK_INPUT_BUFFER_SIZE > CK_ALLOC_SIZE ? CK_INPUT_BUFFER_SIZE : CK_ALLOC_SIZE;
+
+        if((CK_ALLOC_BUFFER = (void *)realloc(CK_INPUT_BUFFER, CK_INPUT_BUFFER_SIZE * sizeof(char))) == NULL) {
+            perror("Error reallocating memory for CK_INPUT_BUFFER: ");
+            exit(EXIT_FAILURE);
+        }
+
+        CK_INPUT_BUFFER = (char *)CK_ALLOC_BUFFER;
+    }
+
+    return CK_INPUT_BUFFER + CK_INPUT_BUFFER_END;
+}
+
+void ck_decode_input(const char *bytes, size_t len, ck_event_callback callback, void *data) { // Add input read from the terminal to CK_INPUT_BUFFER (`bytes' can be NULL if it was read straight in), and pass each event decoded from it to `callback' (anything incomplete is kept until the rest arrives)
+    struct ck_event event,
+                    motion; // Mouse movements are held back so that only the latest gets delivered
+    size_t start = 0,
+           used;
+
+    if(len)
+        memcpy(ck_reserve_input(len), bytes, len),
+        CK_INPUT_BUFFER_END += len,
+        CK_INPUT_READ_TIME = ck_now();
+
+    for(motion.type = 0; start < CK_INPUT_BUFFER_END && (used = ck_parse_input(CK_INPUT_BUFFER + start, CK_INPUT_BUFFER_END - start, &event)); start += used) {
+        event.time = CK_INPUT_READ_TIME;
+
+        if(event.type == CK_EVENT_MOUSE_MOVE) {
+            motion = event;
+            continue;
+        }
+
+        if(motion.type) // Keep it in order with anything else
+            callback(&motion, data),
+            motion.type = 0;
+
+        if(event.type)
+            callback(&event, data);
+    }
+
+    if(motion.type)
+        callback(&motion, data);
+
+    // Keep whatever's incomplete for next time:
+
+    memmove(CK_INPUT_BUFFER, CK_INPUT_BUFFER + start, CK_INPUT_BUFFER_END -= start);
+}
+
+// Input thread (for apps whose rendering runs separately from their input handling; Unix-like only for now):
+
+#ifndef _WIN32
+
+#ifndef CK_EVENT_QUEUE_SIZE
+#define CK_EVENT_QUEUE_SIZE 1024 /* How many events the input thread can get ahead by (must be a power of 2) */
+#endif
+
+struct ck_event CK_EVENT_QUEUE[CK_EVENT_QUEUE_SIZE]; // Decoded events, passed from the input thread to ck_poll_event() without locking
+
+_Alignas(64) atomic_size_t CK_EVENT_QUEUE_HEAD; // Next to be taken (only written by ck_poll_event(), and on its own cache line so the two sides don't keep stealing it from each other)
+_Alignas(64) atomic_size_t CK_EVENT_QUEUE_TAIL; // Next to be filled (only written by the input thread)
+
+char *CK_EVENT_QUEUE_PASTE; // Copy of the last paste taken by ck_poll_event(), freed on the next call
+
+int CK_INPUT_THREAD_PIPE[2]; // Written to by ck_stop_input_thread() to wake the input thread up
+
+ck_thread CK_INPUT_THREAD;
+
+static size_t ck_read_input(int fd) { // Read everything that's available from `fd' straight into CK_INPUT_BUFFER, returning how much was read (0 at the end of input)
+    struct pollfd more = {.fd = fd,
+                          .events = POLLIN,
+                          .revents = 0};
+    size_t total = 0;
+    ssize_t len;
+
+    CK_INPUT_READ_TIME = ck_now();
+
+    // Keep going while there's more, so a flood of input (mouse movement, say) gets decoded in one go:
+
+    do {
+        if((len = read(fd, ck_reserve_input(4096), 4096)) <= 0)
+            break;
+
+        CK_INPUT_BUFFER_END += len,
+        total += len;
+    } while(len == 4096 && poll(&more, 1, 0) > 0);
+
+    return total;
+}
+
+static void ck_queue_event(const struct ck_event *event, void *data) { // Event callback for the input thread, adding each to CK_EVENT_QUEUE (waiting if it's full)
+    size_t tail = atomic_load_explicit(&CK_EVENT_QUEUE_TAIL, memory_order_relaxed);
+    struct ck_event *slot = &CK_EVENT_QUEUE[tail & (CK_EVENT_QUEUE_SIZE - 1)];
+    struct timespec pause = {0, 50000}; // 50us, doubling up to 5ms
+
+    (void)data;
+
+    // The render loop is behind, so give it a moment (rather than dropping input, or making ck_poll_event() signal anything):
+
+    while(tail - atomic_load_explicit(&CK_EVENT_QUEUE_HEAD, memory_order_acquire) == CK_EVENT_QUEUE_SIZE)
+        nanosleep(&pause, NULL),
+        pause.tv_nsec = pause.tv_nsec < 2500000 ? pause.tv_nsec * 2 : 5000000;
+
+    *slot = *event;
+
+    // Paste text is only valid until the callback returns, so the queue needs its own copy:
+
+    if(event->type == CK_EVENT_PASTE) {
+        if((slot->text = (const char *)malloc(event->len ? event->len : 1)) == NULL) {
+            perror("Error allocating memory for paste: ");
+            exit(EXIT_FAILURE);
+        }
+
+        memcpy((char *)slot->text, event->text, event->len);
+    }
+
+    atomic_store_explicit(&CK_EVENT_QUEUE_TAIL, tail + 1, memory_order_release); // Publish it
+}
+
+_Bool ck_poll_event(struct ck_event *event) { // Take the next event from the input thread, if there is one (never blocks, locks, or makes a system call; a paste's text is valid until the next call)
+    size_t head = atomic_load_explicit(&CK_EVENT_QUEUE_HEAD, memory_order_relaxed);
+
+    free(CK_EVENT_QUEUE_PASTE);
+    CK_EVENT_QUEUE_PASTE = NULL;
+
+    if(head == atomic_load_explicit(&CK_EVENT_QUEUE_TAIL, memory_order_acquire))
+        return 0;
+
+    *event = CK_EVENT_QUEUE[head & (CK_EVENT_QUEUE_SIZE - 1)];
+
+    if(event->type == CK_EVENT_PASTE)
+        CK_EVENT_QUEUE_PASTE = (char *)event->text;
+
+    ck_latency_mark(event);
+
+    atomic_store_explicit(&CK_EVENT_QUEUE_HEAD, head + 1, memory_order_release); // Give the slot back
+
+    return 1;
+}
+
+static void *ck_input_thread(void *unused) { // Block on stdin, decoding whatever arrives into CK_EVENT_QUEUE, until woken by ck_stop_input_thread()
+    struct pollfd fds[] = {{.fd = STDIN_FILENO, .events = POLLIN, .revents = 0},
+                           {.fd = CK_INPUT_THREAD_PIPE[0], .events = POLLIN, .revents = 0}};
+
+    (void)unused;
+
+    for(;;) {
+        if(poll(fds, 2, -1) < 0) {
+            if(errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        if(fds[1].revents || !ck_read_input(STDIN_FILENO)) // Told to stop, or end of input
+            break;
+
+        ck_decode_input(NULL, 0, ck_queue_event, NULL);
+    }
+
+    return NULL;
+}
+
+void ck_start_input_thread(void) { // Start a thread that reads and decodes input for ck_poll_event() (it owns CK_INPUT_BUFFER while running, so don't use ck_run() at the same time)
+    if(pipe(CK_INPUT_THREAD_PIPE) < 0) {
+        perror("Error creating pipe for input thread: ");
+        exit(EXIT_FAILURE);
+    }
+
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_SETTS); // Read input raw
+
+    CK_INPUT_THREAD = ck_thread_start(ck_input_thread, NULL);
+}
+
+void ck_stop_input_thread(void) { // Stop the thread started by ck_start_input_thread() (events it has already queued can still be taken)
+    if(write(CK_INPUT_THREAD_PIPE[1], "", 1) < 0)
+        perror("Error stopping input thread: ");
+
+    ck_thread_join(CK_INPUT_THREAD);
+
+    close(CK_INPUT_THREAD_PIPE[0]);
+    close(CK_INPUT_THREAD_PIPE[1]);
+
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_ORIG_SETTS);
+}
+
+#endif
+
+// Event loop (Linux only for now, since it's built on epoll):
+
+#ifdef __linux__
+
+#include <sys/epoll.h> // For waiting on everything at once
+#include <sys/signalfd.h> // For resizes
+#include <sys/timerfd.h> // For timers
+
+struct ck_watch { // Something the event loop is waiting on
+    int fd;
+    ck_fd_callback callback; // For user fds
+    ck_timer_callback timer; // For timers
+    void *data;
+};
+
+size_t CK_WATCH_BUFFER_SIZE,
+       CK_WATCH_BUFFER_END;
+
+struct ck_watch *CK_WATCH_BUFFER; // User fds and timers being waited on
+
+int CK_LOOP_FD, // The epoll instance (0 until first needed, since that's stdin so can't be it)
+    CK_RESIZE_FD = -1; // signalfd for SIGWINCH while ck_run() is running
+
+_Bool CK_LOOP_RUNNING;
+
+ck_event_callback CK_EVENT_CALLBACK; // What gets input and resize events
+void *CK_EVENT_DATA;
+
+static void ck_loop_watch(int fd) { // Add an fd to the epoll instance (creating it if needed)
+    struct epoll_event watch = {.events = EPOLLIN,
+                                .data = {.fd = fd}};
+
+    if(!CK_LOOP_FD && (CK_LOOP_FD = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        perror("Error creating epoll instance: ");
+        exit(EXIT_FAILURE);
+    }
+
+    if(epoll_ctl(CK_LOOP_FD, EPOLL_CTL_ADD, fd, &watch) < 0)
+        perror("Error watching fd: "); // Not fatal (regular files can't be watched, for instance)
+}
+
+void ck_on_event(ck_event_callback callback, void *data) { // Set what gets called for input and resizes while ck_run() is running
+    CK_EVENT_CALLBACK = callback,
+    CK_EVENT_DATA = data;
+}
+
+void ck_add_fd(int fd, ck_fd_callback callback, void *data) { // Have `callback' called whenever `fd' is readable while ck_run() is running
+    // Automatic reallocation if needed:
+
+    if(CK_WATCH_BUFFER_END == CK_WATCH_BUFFER_SIZE) {
+        CK_WATCH_BUFFER_SIZE = CK_WATCH_BUFFER_SIZE ? 2 * CK_WATCH_BUFFER_SIZE : 8;
+
+        if((CK_ALLOC_BUFFER = (void *)realloc(CK_WATCH_BUFFER, CK_WATCH_BUFFER_SIZE * sizeof(struct ck_watch))) == NULL) {
+            perror("Error reallocating memory for CK_WATCH_BUFFER: ");
+            exit(EXIT_FAILURE);
+        }
+
+        CK_WATCH_BUFFER = (struct ck_watch *)CK_ALLOC_BUFFER;
+    }
+
+    CK_WATCH_BUFFER[CK_WATCH_BUFFER_END++] = (struct ck_watch){fd, callback, NULL, data};
+
+    ck_loop_watch(fd);
+}
+
+void ck_remove_fd(int fd) { // Stop watching an fd added with ck_add_fd() (or a timer from ck_add_timer(), which also gets closed)
+    size_t i;
+
+    for(i = 0; i < CK_WATCH_BUFFER_END; i++)
+        if(CK_WATCH_BUFFER[i].fd == fd) {
+            epoll_ctl(CK_LOOP_FD, EPOLL_CTL_DEL, fd, NULL);
+
+            if(CK_WATCH_BUFFER[i].timer)
+                close(fd);
+
+            CK_WATCH_BUFFER[i] = CK_WATCH_BUFFER[--CK_WATCH_BUFFER_END];
+
+            return;
+        }
+}
+
+#define ck_remove_timer(timer) ck_remove_fd(timer) /* Stop a timer from ck_add_timer() */
+
+int ck_add_timer(unsigned int interval, ck_timer_callback callback, void *data) { // Have `callback' called every `interval' ms while ck_run() is running (missed ticks are merged into one), returning the timer to pass to ck_remove_timer()
+    struct itimerspec spec = {{interval / 1000, interval % 1000 * 1000000},
+                              {interval / 1000, interval % 1000 * 1000000}};
+    int fd;
+
+    if((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0 || timerfd_settime(fd, 0, &spec, NULL) < 0) {
+        perror("Error creating timer: ");
+        exit(EXIT_FAILURE);
+    }
+
+    ck_add_fd(fd, NULL, data);
+    CK_WATCH_BUFFER[CK_WATCH_BUFFER_END - 1].timer = callback;
+
+    return fd;
+}
+
+void ck_stop(void) { // Have ck_run() return once it's finished dispatching what's ready
+    CK_LOOP_RUNNING = 0;
+}
+
+static void ck_deliver_event(const struct ck_event *event, void *unused) { // Pass an event on to the CK_EVENT_CALLBACK, counting its latency
+    (void)unused;
+
+    ck_latency_mark(event);
+    CK_EVENT_CALLBACK(event, CK_EVENT_DATA);
+}
+
+static void ck_dispatch(int fd) { // Handle an fd that epoll says is ready
+    struct signalfd_siginfo info;
+    struct ck_console_size size;
+    struct ck_event event;
+    unsigned long long expirations;
+    size_t i;
+
+    memset(&event, 0, sizeof(event));
+
+    event.type = CK_EVENT_RESIZE;
+
+    if(fd == STDIN_FILENO) {
+        if(ck_read_input(STDIN_FILENO)) {
+            if(CK_EVENT_CALLBACK)
+                ck_decode_input(NULL, 0, ck_deliver_event, NULL);
+        }
+        else // End of input, which would otherwise stay readable forever
+            epoll_ctl(CK_LOOP_FD, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+
+        return;
+    }
+
+    if(fd == CK_RESIZE_FD) {
+        while(read(CK_RESIZE_FD, &info, sizeof(info)) == sizeof(info)); // Several resizes in a row only need handling once
+
+        size = ck_current_console_size();
+
+        if(size.has_changed && CK_EVENT_CALLBACK)
+            event.width = size.width,
+            event.height = size.height,
+            event.time = ck_now(),
+            ck_deliver_event(&event, NULL);
+
+        return;
+    }
+
+    for(i = 0; i < CK_WATCH_BUFFER_END; i++)
+        if(CK_WATCH_BUFFER[i].fd == fd) {
+            if(CK_WATCH_BUFFER[i].timer) {
+                if(read(fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                    CK_WATCH_BUFFER[i].timer(CK_WATCH_BUFFER[i].data);
+            }
+            else
+                CK_WATCH_BUFFER[i].callback(fd, CK_WATCH_BUFFER[i].data);
+
+            return;
+        }
+}
+
+sigset_t CK_ORIGINAL_SIGNAL_MASK; // To put back after ck_loop_end()
+
+void ck_loop_start(void) { // Get ready to dispatch events (ck_run() does this itself; only needed for driving things with ck_process_ready() from another event loop)
+    sigset_t resize;
+
+    // Read input raw, and take SIGWINCH as something to read rather than a signal:
+
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_SETTS);
+
+    sigemptyset(&resize);
+    sigaddset(&resize, SIGWINCH);
+    pthread_sigmask(SIG_BLOCK, &resize, &CK_ORIGINAL_SIGNAL_MASK); // (sigprocmask() isn't safe once there are threads)
+
+    if((CK_RESIZE_FD = signalfd(-1, &resize, SFD_NONBLOCK | SFD_CLOEXEC)) < 0) {
+        perror("Error creating signalfd: ");
+        exit(EXIT_FAILURE);
+    }
+
+    ck_loop_watch(STDIN_FILENO);
+    ck_loop_watch(CK_RESIZE_FD);
+}
+
+void ck_loop_end(void) { // Put things back the way they were before ck_loop_start()
+    epoll_ctl(CK_LOOP_FD, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+    epoll_ctl(CK_LOOP_FD, EPOLL_CTL_DEL, CK_RESIZE_FD, NULL);
+
+    close(CK_RESIZE_FD);
+    CK_RESIZE_FD = -1;
+
+    pthread_sigmask(SIG_SETMASK, &CK_ORIGINAL_SIGNAL_MASK, NULL);
+    tcsetattr(0, TCSANOW, &CK_CONSOLE_ORIG_SETTS);
+}
+
+int ck_wait_and_dispatch(int timeout) { // Wait up to `timeout' ms (-1 for as long as it takes) for anything to be ready and dispatch it, returning how many things were
+    struct epoll_event ready[16];
+    int count, i;
+
+    if((count = epoll_wait(CK_LOOP_FD, ready, sizeof(ready) / sizeof(ready[0]), timeout)) < 0) {
+        if(errno != EINTR)
+            perror("Error waiting for events: ");
+
+        return 0;
+    }
+
+    for(i = 0; i < count; i++)
+        ck_dispatch(ready[i].data.fd);
+
+    return count;
+}
+
+void ck_run(void) { // Wait for input, resizes, timers, and added fds, calling their callbacks, until ck_stop() is called (nothing is done in between, so it's idle while there's nothing to do)
+    ck_loop_start();
+
+    for(CK_LOOP_RUNNING = 1; CK_LOOP_RUNNING;)
+        ck_wait_and_dispatch(-1);
+
+    ck_loop_end();
+}
+
+// Following files (as they're written to, like `tail -f'):
+
+#include <sys/inotify.h> // For finding out when they are
+
+#define CK_VIEW_WATCH_EVENTS (IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF) /* Written to, truncated, or rotated away */
+
+static void ck_view_changed(int fd, void *data) { // Note that a followed view's file has changed, starting the timer for its next refresh if it isn't already (so everything up until then is shown at once)
+    struct ck_view *view = (struct ck_view *)data;
+    struct itimerspec once = {{0, 0}, {view->interval / 1000, view->interval % 1000 * 1000000}};
+    char events[4096];
+
+    while(read(fd, events, sizeof(events)) > 0); // Only that something happened matters
+
+    if(!view->pending)
+        view->pending = 1,
+        timerfd_settime(view->timer, 0, &once, NULL);
+}
+
+static void ck_view_refresh(void *data) { // Show what's changed in a followed view's file
+    struct ck_view *view = (struct ck_view *)data;
+
+    view->pending = 0;
+
+    inotify_add_watch(view->watch, view->path, CK_VIEW_WATCH_EVENTS); // In case it's been rotated, so a new file has the path now (a no-op otherwise)
+
+    ck_view_update(view);
+    ck_flip();
+}
+
+_Bool ck_view_follow(struct ck_view *view, unsigned int interval) { // Like `tail -f': while ck_run() is running, ck_view_update() and ck_flip() within `interval' ms of the view's file being written to (everything written in between shows up in the same frame), returning 0 if the file can't be watched
+    struct itimerspec stopped = {{0, 0}, {0, 0}};
+
+    if((view->watch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0)
+        return 0;
+
+    if(inotify_add_watch(view->watch, view->path, CK_VIEW_WATCH_EVENTS) < 0) {
+        close(view->watch);
+        view->watch = -1;
+
+        return 0;
+    }
+
+    view->interval = interval ? interval : 1,
+    view->pending = 0;
+
+    ck_add_fd(view->watch, ck_view_changed, view);
+
+    view->timer = ck_add_timer(view->interval, ck_view_refresh, view);
+    timerfd_settime(view->timer, 0, &stopped, NULL); // Only running while a refresh is due, so nothing happens while the file isn't being written to
+
+    return 1;
+}
+
+void ck_view_unfollow(struct ck_view *view) { // Stop following a view's file (ck_view_close() does this itself)
+    ck_remove_fd(view->watch);
+    ck_remove_timer(view->timer);
+    close(view->watch);
+
+    view->watch = view->timer = -1,
+    view->pending = 0;
+}
+
+// Animating progress bars:
+
+static void ck_progress_tick(void *data) { // Show how far the tasks have got
+    ck_progress_update((struct ck_progress *)data);
+    ck_flip();
+}
+
+void ck_progress_start(struct ck_progress *progress, unsigned int interval) { // While ck_run() is running, ck_progress_update() and ck_flip() every `interval' ms
+    progress->timer = ck_add_timer(interval ? interval : 1, ck_progress_tick, progress);
+}
+
+void ck_progress_stop(struct ck_progress *progress) { // Stop redrawing progress bars (ck_progress_free() does this itself)
+    ck_remove_timer(progress->timer);
+
+    progress->timer = -1;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#ifdef __cplusplus // (See the top)
+#undef atomic_size_t
+#undef atomic_load_explicit
+#undef atomic_store_explicit
+#undef atomic_store
+#undef atomic_fetch_add_explicit
+#undef atomic_exchange_explicit
+#undef memory_order_relaxed
+#undef memory_order_acquire
+#undef memory_order_release
+
+#undef _Bool
+#undef _Alignas
+#endif
@@ -0,0 +1,192 @@
+/* Conkit -- compile-time escape sequences for C++ (17 or later), to #include instead of conkit.h
+ * Copyright (C) 2023 Finn Chipp
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Everything here is constexpr, so sequences built from constexpr values (colour constants, theme tables,
+// fixed layouts) are formatted by the compiler and end up as plain bytes in the binary, e.g.
+//
+//     constexpr auto chrome = CK_EXACT(ck::concat(ck::cursor_goto(1, 1), ck::sgr(THEME.title, THEME.bar, CK_ATTR_BOLD),
+//                                                 ck::text(" conkit "), ck::reset()));
+//     ...
+//     ck::write(chrome); // No sprintf, just a copy into the CK_SCREEN_BUFFER
+
+#ifndef CONKIT_HPP
+#define CONKIT_HPP
+
+#include <array>
+#include <cstddef>
+
+#include "conkit.h"
+
+namespace ck {
+    template<std::size_t N> struct sequence { // Up to `N' chars of escape sequences and text, not \0-terminated
+        std::array<char, N> chars{};
+        std::size_t len = 0;
+
+        constexpr const char *data() const { return chars.data(); } // For passing to ck_write()
+        constexpr std::size_t size() const { return len; }
+
+        constexpr sequence &put(char c) { // Append a char
+            chars[len++] = c;
+
+            return *this;
+        }
+
+        constexpr sequence &put(const char *text, std::size_t count) { // Append `count' chars of `text'
+            for(std::size_t i = 0; i < count; i++)
+                chars[len++] = text[i];
+
+            return *this;
+        }
+
+        template<std::size_t M> constexpr sequence &put(const sequence<M> &other) { // Append another sequence
+            return put(other.data(), other.size());
+        }
+
+        constexpr sequence &number(unsigned long long n) { // Append `n' in decimal
+            char digits[20] = {};
+            std::size_t count = 0;
+
+            do
+                digits[count++] = '0' + n % 10;
+            while(n /= 10);
+
+            while(count)
+                chars[len++] = digits[--count];
+
+            return *this;
+        }
+    };
+
+    template<std::size_t N> constexpr sequence<N - 1> text(const char (&literal)[N]) { // Wrap a string literal (without its \0)
+        sequence<N - 1> out;
+
+        out.put(literal, N - 1);
+
+        return out;
+    }
+
+    template<std::size_t... N> constexpr sequence<(N + ... + 0)> concat(const sequence<N> &...parts) { // Join sequences end-to-end, such as all the static fragments of a frame
+        sequence<(N + ... + 0)> out;
+
+        (out.put(parts), ...);
+
+        return out;
+    }
+
+    template<std::size_t Exact, std::size_t N> constexpr sequence<Exact> exact(const sequence<N> &seq) { // Copy `seq' into a sequence with no room to spare (see CK_EXACT())
+        sequence<Exact> out;
+
+        out.put(seq.data(), Exact);
+
+        return out;
+    }
+
+    #define CK_EXACT(seq) ck::exact<(seq).size()>(seq) /* Shrink a constant sequence to its actual length, so its `chars' is exactly the bytes to send */
+
+    constexpr sequence<16> colour(unsigned char base, unsigned int colour) { // SGR parameters (without `CSI' or `m') for a conkit colour (base 30 for foreground, 40 for background), as ck_sgr_colour() writes them
+        sequence<16> out;
+
+        if(colour & CK_COLOUR_DEFAULT)
+            return out.number(base + 9), out;
+
+        out.number(base + 8);
+
+        if(colour & CK_COLOUR_PALETTE)
+            return out.put(";5;", 3).number(colour & 0xFF), out;
+
+        out.put(";2;", 3).number(colour >> 16 & 0xFF).put(';').number(colour >> 8 & 0xFF).put(';').number(colour & 0xFF);
+
+        return out;
+    }
+
+    constexpr sequence<19> fg(unsigned int c) { // Foreground colour (see ck_colour_rgb(), ck_colour_256(), CK_COLOUR_DEFAULT)
+        sequence<19> out;
+
+        out.put("\033[", 2).put(colour(30, c)).put('m');
+
+        return out;
+    }
+
+    constexpr sequence<19> bg(unsigned int c) { // Background colour
+        sequence<19> out;
+
+        out.put("\033[", 2).put(colour(40, c)).put('m');
+
+        return out;
+    }
+
+    constexpr sequence<52> sgr(unsigned int fgColour, unsigned int bgColour, unsigned char attr = 0) { // Full formatting from scratch, the same as ck_sgr() sends when the terminal's state is unknown
+        constexpr unsigned char attrCodes[] = {1, 2, 3, 4, 5, 7}; // In the order of the CK_ATTR_* bits
+
+        sequence<52> out;
+
+        out.put("\033[0", 3);
+
+        for(std::size_t i = 0; i < sizeof(attrCodes); i++)
+            if(attr & 1 << i)
+                out.put(';').number(attrCodes[i]);
+
+        out.put(';').put(colour(30, fgColour)).put(';').put(colour(40, bgColour)).put('m');
+
+        return out;
+    }
+
+    constexpr sequence<4> reset() { // Same as CK_RESET_FORMATTING
+        return text(CK_RESET_FORMATTING);
+    }
+
+    constexpr sequence<44> cursor_goto(std::size_t x, std::size_t y) { // Cursor movement to specified co-ordinates
+        sequence<44> out;
+
+        out.put("\033[", 2).number(y).put(';').number(x).put('H');
+
+        return out;
+    }
+
+    constexpr sequence<23> cursor_move(char where, std::size_t amount) { // Cursor movement in a direction relative-to current position (or any other `CSI n x' sequence)
+        sequence<23> out;
+
+        out.put("\033[", 2).number(amount).put(where);
+
+        return out;
+    }
+
+    constexpr sequence<23> cursor_up(std::size_t amount) { return cursor_move('A', amount); }
+    constexpr sequence<23> cursor_down(std::size_t amount) { return cursor_move('B', amount); }
+    constexpr sequence<23> cursor_right(std::size_t amount) { return cursor_move('C', amount); }
+    constexpr sequence<23> cursor_left(std::size_t amount) { return cursor_move('D', amount); }
+
+    constexpr sequence<23> scroll_up(std::size_t amount) { return cursor_move('S', amount); }
+    constexpr sequence<23> scroll_down(std::size_t amount) { return cursor_move('T', amount); }
+
+    constexpr sequence<23> insert_lines(std::size_t amount) { return cursor_move('L', amount); }
+    constexpr sequence<23> delete_lines(std::size_t amount) { return cursor_move('M', amount); }
+
+    constexpr sequence<44> scroll_region(std::size_t top, std::size_t bottom) { // Restricting scrolling to lines `top' to `bottom' (inclusive)
+        sequence<44> out;
+
+        out.put("\033[", 2).number(top).put(';').number(bottom).put('r');
+
+        return out;
+    }
+
+    template<std::size_t N> inline void write(const sequence<N> &seq) { // Write a sequence to the CK_SCREEN_BUFFER
+        ck_write(seq.data(), seq.size());
+    }
+}
+
+#endif